@@ -3,14 +3,283 @@
 #include <map>
 #include <set>
 #include <sstream>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <random>
+
+#include "automata.h"
+
+#ifdef _WIN32
+#define DFA_NO_MMAP
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
-map<string, map<char, string>> dfa;
-set<string> final_states;
-string start_state = "X";
+// DFA 识别。稠密转移表和多路交错内核在 automata 库中（match.cpp），
+// 这里负责读入评测格式的DFA、交互/批量模式的输入输出和基准测试
+using automata::DenseDFA;
+using automata::Span;
+using automata::DEAD_STATE;
+
+DenseDFA dense;
+
+// 多路识别使用的内核。gather 在不少 CPU 上并不比分散的标量读取快
+// （见 --bench 的结果），所以默认使用 16 路标量交错内核，由 --avx2 显式开启 AVX2 gather
+automata::MatchKernel kernel = automata::MatchKernel::Scalar16;
+
+// 识别一个串，结果追加到 out。trace 为 true 时逐字符回显（评测要求的格式）：
+// 回显每个成功转移的字符，出错时停止
+bool recognize(const char* s, size_t len, bool trace, string& out) {
+    size_t consumed;
+    bool accepted = automata::match(dense, s, len, &consumed);
+    if (trace) {
+        for (size_t i = 0; i < consumed; i++) {
+            out += s[i];
+            out += '\n';
+        }
+    }
+    out += accepted ? "pass\n" : "error\n";
+    return accepted;
+}
+
+// 只读映射整个输入文件；不支持 mmap 的平台退化为一次性读入
+struct InputFile {
+    const char* data = nullptr;
+    size_t size = 0;
+    string fallback;
+#ifndef DFA_NO_MMAP
+    void* mapped = nullptr;
+#endif
+
+    bool open(const char* path) {
+#ifndef DFA_NO_MMAP
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        if (!S_ISREG(st.st_mode)) {
+            // 管道等无法映射，直接读入内存
+            char buf[1 << 16];
+            ssize_t n;
+            while ((n = ::read(fd, buf, sizeof(buf))) > 0) fallback.append(buf, (size_t)n);
+            ::close(fd);
+            data = fallback.data();
+            size = fallback.size();
+            return true;
+        }
+        size = (size_t)st.st_size;
+        if (size > 0) {
+            mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                mapped = nullptr;
+                ::close(fd);
+                return false;
+            }
+            madvise(mapped, size, MADV_SEQUENTIAL);
+            data = (const char*)mapped;
+        }
+        ::close(fd);
+        return true;
+#else
+        ifstream in(path, ios::binary);
+        if (!in.is_open()) return false;
+        fallback.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        data = fallback.data();
+        size = fallback.size();
+        return true;
+#endif
+    }
+
+    ~InputFile() {
+#ifndef DFA_NO_MMAP
+        if (mapped) munmap(mapped, size);
+#endif
+    }
+};
+
+// 识别 [begin, end) 中的每一行（均以行首开始），每个非空行输出一行 pass / error
+size_t recognizeLines(const char* begin, const char* end, string& out) {
+    vector<Span> spans;
+    const char* p = begin;
+    while (p < end) {
+        const char* nl = (const char*)memchr(p, '\n', end - p);
+        const char* lineEnd = nl ? nl : end;
+        const char* q = lineEnd;
+        if (q > p && q[-1] == '\r') q--;
+        // 与交互模式一致：跳过空行，去掉行尾的 '#'
+        if (q > p) {
+            if (q[-1] == '#') q--;
+            spans.push_back({p, (size_t)(q - p)});
+        }
+        p = nl ? nl + 1 : end;
+    }
+
+    vector<uint8_t> verdicts;
+    automata::matchMany(dense, spans, verdicts, kernel);
+    for (uint8_t v : verdicts) out += v ? "pass\n" : "error\n";
+    return spans.size();
+}
+
+// 批量模式：输入文件按行对齐切块，多线程并行识别，按输入顺序写出结果
+int runBatch(const char* inPath, const char* outPath, unsigned threadCount) {
+    InputFile input;
+    if (!input.open(inPath)) {
+        cerr << "无法打开输入文件 " << inPath << endl;
+        return 1;
+    }
+    FILE* outFile = stdout;
+    if (outPath) {
+        outFile = fopen(outPath, "wb");
+        if (!outFile) {
+            cerr << "无法打开输出文件 " << outPath << endl;
+            return 1;
+        }
+    }
+    static char writeBuffer[1 << 20];
+    setvbuf(outFile, writeBuffer, _IOFBF, sizeof(writeBuffer));
+
+    if (threadCount == 0) threadCount = thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+
+    // 块数取线程数的若干倍，便于负载均衡；每块约 1MB 以上
+    const size_t minChunk = 1 << 20;
+    size_t chunkCount = (size_t)threadCount * 8;
+    if (input.size / chunkCount < minChunk) chunkCount = input.size / minChunk + 1;
+
+    // 块边界移动到下一个换行符之后，保证每行完整地落在一个块里
+    vector<const char*> bounds;
+    const char* base = input.data;
+    const char* end = input.data + input.size;
+    bounds.push_back(base);
+    for (size_t i = 1; i < chunkCount; i++) {
+        const char* p = base + input.size / chunkCount * i;
+        if (p <= bounds.back()) continue;
+        const char* nl = (const char*)memchr(p, '\n', end - p);
+        if (!nl) break;
+        bounds.push_back(nl + 1);
+    }
+    bounds.push_back(end);
+    chunkCount = bounds.size() - 1;
+
+    vector<string> results(chunkCount);
+    vector<uint8_t> done(chunkCount, 0);
+    atomic<size_t> nextChunk(0);
+    atomic<size_t> totalLines(0);
+    mutex mtx;
+    condition_variable cv;
+
+    auto start = chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        size_t lines = 0;
+        while (true) {
+            size_t i = nextChunk.fetch_add(1);
+            if (i >= chunkCount) break;
+            string buf;
+            buf.reserve((bounds[i + 1] - bounds[i]) / 2 + 16);
+            lines += recognizeLines(bounds[i], bounds[i + 1], buf);
+            lock_guard<mutex> lock(mtx);
+            results[i].swap(buf);
+            done[i] = 1;
+            cv.notify_one();
+        }
+        totalLines += lines;
+    };
+
+    vector<thread> pool;
+    for (unsigned t = 0; t < threadCount; t++) pool.emplace_back(worker);
+
+    // 主线程作为唯一的写出者，按块顺序输出，写完即释放该块的结果
+    for (size_t i = 0; i < chunkCount; i++) {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [&]() { return done[i] != 0; });
+        string buf;
+        buf.swap(results[i]);
+        lock.unlock();
+        fwrite(buf.data(), 1, buf.size(), outFile);
+    }
+    for (auto& t : pool) t.join();
+    fflush(outFile);
+    if (outFile != stdout) fclose(outFile);
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << "lines: " << totalLines.load() << ", threads: " << threadCount
+         << ", time: " << seconds << "s, " << (size_t)(totalLines.load() / (seconds > 0 ? seconds : 1e-9))
+         << " lines/s" << endl;
+    return 0;
+}
+
+// 基准测试：随机生成不同长度的串，比较单路循环与多路交错内核
+void runBenchmark() {
+    // 用 DFA 中出现过的字符生成输入，使大部分串能走完全程
+    string alphabet;
+    for (int c = 0; c < 256; c++) {
+        for (size_t u = 0; u < dense.accepting.size(); u++) {
+            if (dense.table[u * 256 + c] != DEAD_STATE) {
+                alphabet += (char)c;
+                break;
+            }
+        }
+    }
+    if (alphabet.empty()) alphabet = "a";
+
+    mt19937 rng(12345);
+    const size_t lengths[] = {4, 16, 64, 256, 1024};
+    cout << "len\tstrings\tsingle(ns/B)\tscalar8\tscalar16\tavx2" << endl;
+    for (size_t len : lengths) {
+        size_t count = (16u << 20) / len;
+        string buffer(count * len, 0);
+        for (auto& c : buffer) c = alphabet[rng() % alphabet.size()];
+        vector<Span> spans(count);
+        for (size_t i = 0; i < count; i++) spans[i] = {buffer.data() + i * len, len};
+
+        auto measure = [&](automata::MatchKernel k, vector<uint8_t>& v) {
+            auto t0 = chrono::steady_clock::now();
+            automata::matchMany(dense, spans, v, k);
+            return chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count() / buffer.size();
+        };
+
+        vector<uint8_t> ref(count), v8, v16, vavx;
+        auto t0 = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; i++) ref[i] = automata::match(dense, spans[i].s, spans[i].len);
+        double single = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count() / buffer.size();
+        double scalar8 = measure(automata::MatchKernel::Scalar8, v8);
+        double scalar16 = measure(automata::MatchKernel::Scalar16, v16);
+        cout << len << "\t" << count << "\t" << single
+             << "\t" << scalar8 << " (x" << single / scalar8 << ")"
+             << "\t" << scalar16 << " (x" << single / scalar16 << ")";
+        if (automata::cpuHasAVX2()) {
+            double avx = measure(automata::MatchKernel::AVX2, vavx);
+            cout << "\t" << avx << " (x" << single / avx << ")";
+            if (vavx != ref) cout << " MISMATCH";
+        } else cout << "\tn/a";
+        if (v8 != ref || v16 != ref) cout << " MISMATCH";
+        cout << endl;
+    }
+}
+
+// 读入文本格式的字母表、状态集合和转换表，转换成整数编号的DFA
+automata::AutomatonData readDfaText() {
+    map<string, map<char, string>> dfa;
+    set<string> finalStates;
+    const string startState = "X";
 
-int main() {
     string token;
     // 1. 读取字母表
     while (cin >> token) {
@@ -22,7 +291,7 @@ int main() {
         string s = token;
         if (s.back() == '#') s.pop_back();
         // 题目约定 Y 为终态
-        if (s == "Y") final_states.insert(s);
+        if (s == "Y") finalStates.insert(s);
         if (token.back() == '#') break;
     }
 
@@ -39,7 +308,6 @@ int main() {
             size_t arrow = part.find("->");
             size_t dash = part.find('-');
 
-
             if (arrow != string::npos && dash != string::npos) {
                 string u = part.substr(0, dash);      // 源状态
                 char c = part[dash + 1];              // 输入字符
@@ -49,6 +317,80 @@ int main() {
         }
     }
 
+    // 状态名统一编号：初态 X 为 0，其余按出现顺序
+    map<string, uint32_t> ids;
+    vector<string> names;
+    auto intern = [&](const string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        uint32_t id = (uint32_t)names.size();
+        ids[name] = id;
+        names.push_back(name);
+        return id;
+    };
+    intern(startState);
+    for (const auto& row : dfa) {
+        intern(row.first);
+        for (const auto& edge : row.second) intern(edge.second);
+    }
+
+    automata::AutomatonData data;
+    data.flags = automata::FLAG_DETERMINISTIC;
+    for (const auto& name : names) {
+        data.addState(name, finalStates.count(name) != 0);
+        auto row = dfa.find(name);
+        if (row == dfa.end()) continue;
+        for (const auto& edge : row->second) data.addEdge(edge.first, ids[edge.second]);
+    }
+    data.startState = 0;
+    return data;
+}
+
+int main(int argc, char* argv[]) {
+    // -q / --quiet：不逐字符回显，只输出 pass / error
+    // --batch <文件>：批量识别文件中的每一行，DFA 仍从标准输入读取
+    //   -o <文件>：批量模式的输出文件（默认标准输出）
+    //   -j <线程数>：批量模式的线程数（默认全部核心）
+    //   --avx2：批量模式使用 AVX2 gather 内核（CPU 支持时）
+    // --bench：对读入的 DFA 比较单路与多路交错识别的速度
+    // --read-bin <文件>：从二进制自动机文件读入 DFA，标准输入只含待识别的串
+    const char* readBinPath = nullptr;
+    bool trace = true;
+    bool bench = false;
+    const char* batchPath = nullptr;
+    const char* outPath = nullptr;
+    unsigned threadCount = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0) trace = false;
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) batchPath = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) outPath = argv[++i];
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) threadCount = (unsigned)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--avx2") == 0) kernel = automata::MatchKernel::AVX2;
+        else if (strcmp(argv[i], "--bench") == 0) bench = true;
+        else if (strcmp(argv[i], "--read-bin") == 0 && i + 1 < argc) readBinPath = argv[++i];
+    }
+
+    string line;
+    automata::MappedAutomaton binFile;
+    if (readBinPath) {
+        string error;
+        if (!binFile.open(readBinPath, error)) {
+            cerr << error << endl;
+            return 1;
+        }
+        dense = automata::buildDenseDFA(binFile.view());
+    } else {
+        dense = automata::buildDenseDFA(readDfaText());
+    }
+
+    if (batchPath) return runBatch(batchPath, outPath, threadCount);
+    if (bench) {
+        runBenchmark();
+        return 0;
+    }
+
+    // 输出先写入缓冲区，避免每个字符都 endl 刷新
+    string out;
     while (getline(cin, line)) {
         if (line.empty()) continue;
 
@@ -59,34 +401,14 @@ int main() {
         if (input_str.empty()) continue;
         if (input_str.back() == '#') input_str.pop_back();
 
-        string curr = start_state;
-        bool error_occurred = false;
-
-
-        for (char c : input_str) {
-
-            if (dfa[curr].count(c)) {
+        recognize(input_str.data(), input_str.size(), trace, out);
 
-                cout << c << endl;
-
-                curr = dfa[curr][c];
-            } else {
-
-                cout << "error" << endl;
-                error_occurred = true;
-                break;
-            }
-        }
-
-
-        if (!error_occurred) {
-            if (final_states.count(curr)) {
-                cout << "pass" << endl;
-            } else {
-                cout << "error" << endl;
-            }
+        if (out.size() >= (1 << 16)) {
+            cout << out;
+            out.clear();
         }
     }
+    cout << out;
 
     return 0;
-}
\ No newline at end of file
+}
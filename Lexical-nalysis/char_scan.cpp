@@ -0,0 +1,214 @@
+#include "char_scan.h"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CHARSCAN_HAVE_X86_KERNELS
+#endif
+
+namespace charscan {
+
+namespace {
+
+// ---------------- 标量内核 ----------------
+
+const char* skipClassScalar(const char* p, const char* end, uint8_t classes) {
+    while (p < end && (classTable[(unsigned char)*p] & classes)) p++;
+    return p;
+}
+
+const char* findCharScalar(const char* p, const char* end, char c) {
+    const void* r = memchr(p, c, end - p);
+    return r ? (const char*)r : end;
+}
+
+#ifdef CHARSCAN_HAVE_X86_KERNELS
+
+// ---------------- SSE2 内核 ----------------
+// SSE2 没有按字节查表的指令，字符类用区间比较表示：x - lo 按无符号比较不超过 hi - lo
+
+inline __m128i inRange(__m128i v, char lo, char hi) {
+    __m128i t = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8((char)(hi - lo))), t);
+}
+
+inline __m128i classMaskSSE2(__m128i v, uint8_t classes) {
+    __m128i m = _mm_setzero_si128();
+    if (classes & SPACE) {
+        m = _mm_or_si128(m, inRange(v, '\t', '\r'));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+    }
+    if (classes & (DIGIT | IDENT)) m = _mm_or_si128(m, inRange(v, '0', '9'));
+    if (classes & IDENT) {
+        // 大小写字母：或上 0x20 后统一为小写
+        m = _mm_or_si128(m, inRange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z'));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+    }
+    return m;
+}
+
+const char* skipClassSSE2(const char* p, const char* end, uint8_t classes) {
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        unsigned outside = ~(unsigned)_mm_movemask_epi8(classMaskSSE2(v, classes)) & 0xFFFF;
+        if (outside) return p + __builtin_ctz(outside);
+        p += 16;
+    }
+    return skipClassScalar(p, end, classes);
+}
+
+const char* findCharSSE2(const char* p, const char* end, char c) {
+    const __m128i needle = _mm_set1_epi8(c);
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        unsigned hit = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle));
+        if (hit) return p + __builtin_ctz(hit);
+        p += 16;
+    }
+    return findCharScalar(p, end, c);
+}
+
+// ---------------- AVX2 内核 ----------------
+// 半字节查表：bits(c) = lowTable[c & 0xF] & highTable[c >> 4]，字符类 k 的成员满足 bits(c) & classBits[k] != 0。
+// 表在编译期由 classTable 生成：对每个字符类，把低半字节集合相同的高半字节归为一组，每组占一位。
+// 高半字节 8-F 的表项为 0，非 ASCII 字节不属于任何字符类
+
+struct NibbleTables {
+    alignas(16) uint8_t low[16] = {};
+    alignas(16) uint8_t high[16] = {};
+    uint8_t classBits[8] = {}; // 下标为字符类的位序号
+    bool ok = false;
+};
+
+constexpr NibbleTables buildNibbleTables() {
+    NibbleTables t;
+    int nextBit = 0;
+    for (int k = 0; k < 3; k++) {
+        uint8_t cls = (uint8_t)(1 << k);
+        uint16_t lowSet[8] = {};
+        for (int h = 0; h < 8; h++) {
+            for (int l = 0; l < 16; l++) {
+                if (classTable[h * 16 + l] & cls) lowSet[h] |= (uint16_t)(1 << l);
+            }
+        }
+        bool done[8] = {false};
+        for (int h = 0; h < 8; h++) {
+            if (done[h] || lowSet[h] == 0) continue;
+            if (nextBit == 8) return t; // 位不够用，不能用查表表示
+            uint8_t bit = (uint8_t)(1 << nextBit++);
+            t.classBits[k] |= bit;
+            for (int l = 0; l < 16; l++) {
+                if (lowSet[h] & (1 << l)) t.low[l] |= bit;
+            }
+            for (int h2 = h; h2 < 8; h2++) {
+                if (lowSet[h2] == lowSet[h]) {
+                    t.high[h2] |= bit;
+                    done[h2] = true;
+                }
+            }
+        }
+    }
+    t.ok = true;
+    return t;
+}
+
+constexpr NibbleTables nibble = buildNibbleTables();
+static_assert(nibble.ok, "字符类不能用半字节查表表示");
+
+uint8_t nibbleBits(uint8_t classes) {
+    uint8_t bits = 0;
+    for (int k = 0; k < 3; k++) {
+        if (classes & (1 << k)) bits |= nibble.classBits[k];
+    }
+    return bits;
+}
+
+__attribute__((target("avx2")))
+const char* skipClassAVX2(const char* p, const char* end, uint8_t classes) {
+    const __m256i lowTable = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)nibble.low));
+    const __m256i highTable = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)nibble.high));
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+    const __m256i bits = _mm256_set1_epi8((char)nibbleBits(classes));
+    const __m256i zero = _mm256_setzero_si256();
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        __m256i lo = _mm256_shuffle_epi8(lowTable, _mm256_and_si256(v, nibbleMask));
+        __m256i hi = _mm256_shuffle_epi8(highTable, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibbleMask));
+        __m256i member = _mm256_and_si256(_mm256_and_si256(lo, hi), bits);
+        unsigned outside = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(member, zero));
+        if (outside) return p + __builtin_ctz(outside);
+        p += 32;
+    }
+    return skipClassSSE2(p, end, classes);
+}
+
+__attribute__((target("avx2")))
+const char* findCharAVX2(const char* p, const char* end, char c) {
+    const __m256i needle = _mm256_set1_epi8(c);
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        unsigned hit = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle));
+        if (hit) return p + __builtin_ctz(hit);
+        p += 32;
+    }
+    return findCharSSE2(p, end, c);
+}
+
+#endif
+
+Kernel bestKernel() {
+#ifdef CHARSCAN_HAVE_X86_KERNELS
+    if (__builtin_cpu_supports("avx2")) return Kernel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return Kernel::SSE2;
+#endif
+    return Kernel::Scalar;
+}
+
+Kernel current = Kernel::Scalar;
+
+void install(Kernel kernel) {
+    current = kernel;
+    switch (kernel) {
+#ifdef CHARSCAN_HAVE_X86_KERNELS
+    case Kernel::AVX2:
+        functions = {skipClassAVX2, findCharAVX2};
+        return;
+    case Kernel::SSE2:
+        functions = {skipClassSSE2, findCharSSE2};
+        return;
+#endif
+    default:
+        functions = {skipClassScalar, findCharScalar};
+        return;
+    }
+}
+
+} // namespace
+
+// 常量初始化为标量内核，其他文件的静态初始化中用到时也能正确扫描
+Functions functions = {skipClassScalar, findCharScalar};
+
+namespace {
+
+// 在静态初始化时（main 之前，还没有其他线程）选好内核，之后只有 setKernel 会修改函数指针
+const bool installed = (install(bestKernel()), true);
+
+} // namespace
+
+Kernel activeKernel() { return current; }
+
+void setKernel(Kernel kernel) {
+    Kernel best = bestKernel();
+    install((int)kernel < (int)best ? kernel : best);
+}
+
+const char* kernelName(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::AVX2: return "avx2";
+    case Kernel::SSE2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+} // namespace charscan
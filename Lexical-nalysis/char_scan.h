@@ -0,0 +1,68 @@
+#ifndef LEXICAL_CHAR_SCAN_H
+#define LEXICAL_CHAR_SCAN_H
+
+// 字符类扫描：一次判断 16 / 32 个字节是否属于某个字符类，用位掩码找到连续段的结尾。
+// 空白、标识符、数字的连续段以及字符串常量的结束引号都用它查找。
+// 内核在程序启动时（静态初始化）按 CPU 选择：AVX2（半字节查表）> SSE2（区间比较）> 标量（256 项分类表）
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace charscan {
+
+// 字符类，可以按位或组合
+const uint8_t SPACE = 1; // 空白：\t \n \v \f \r 和空格（与 C 区域设置下的 isspace 相同）
+const uint8_t DIGIT = 2; // 0-9
+const uint8_t IDENT = 4; // 标识符中的字符：字母、数字、下划线
+
+constexpr std::array<uint8_t, 256> buildClassTable() {
+    std::array<uint8_t, 256> t{};
+    for (int c = '\t'; c <= '\r'; c++) t[c] |= SPACE;
+    t[' '] |= SPACE;
+    for (int c = '0'; c <= '9'; c++) t[c] |= DIGIT | IDENT;
+    for (int c = 'a'; c <= 'z'; c++) t[c] |= IDENT;
+    for (int c = 'A'; c <= 'Z'; c++) t[c] |= IDENT;
+    t['_'] |= IDENT;
+    return t;
+}
+
+// 256 项分类表（编译期生成）：classTable[c] 为字节 c 所属字符类的按位或，0x80 以上的字节不属于任何字符类
+constexpr std::array<uint8_t, 256> classTable = buildClassTable();
+
+enum class Kernel { Scalar, SSE2, AVX2 };
+
+// 当前使用的内核；setKernel 可以强制使用较低的内核（CPU 不支持时忽略），用于比较速度。
+// setKernel 不加锁，只能在没有其他线程扫描时调用
+Kernel activeKernel();
+void setKernel(Kernel kernel);
+const char* kernelName(Kernel kernel);
+
+struct Functions {
+    const char* (*skipClass)(const char* p, const char* end, uint8_t classes);
+    const char* (*findChar)(const char* p, const char* end, char c);
+};
+extern Functions functions;
+
+// 大多数段很短：前 SHORT_RUN 个字节直接查表，段更长时才进入向量内核
+const int SHORT_RUN = 8;
+
+// [p, end) 中第一个不属于 classes 的位置，都属于时返回 end
+inline const char* skipClass(const char* p, const char* end, uint8_t classes) {
+    const char* stop = end - p > SHORT_RUN ? p + SHORT_RUN : end;
+    while (p < stop && (classTable[(unsigned char)*p] & classes)) p++;
+    if (p < stop || p == end) return p;
+    return functions.skipClass(p, end, classes);
+}
+
+// [p, end) 中第一个等于 c 的位置，没有时返回 end
+inline const char* findChar(const char* p, const char* end, char c) {
+    const char* stop = end - p > SHORT_RUN ? p + SHORT_RUN : end;
+    while (p < stop && *p != c) p++;
+    if (p < stop || p == end) return p;
+    return functions.findChar(p, end, c);
+}
+
+} // namespace charscan
+
+#endif
@@ -0,0 +1,91 @@
+#include "incremental_lexer.h"
+
+#include "lexer.h"
+
+IncrementalLexer::IncrementalLexer(std::string_view source) {
+    text_.insert(source.data(), source.size());
+    text_.moveGap(0);
+    Change change;
+    relex(0, source.size(), change);
+}
+
+IncrementalLexer::Span IncrementalLexer::span(size_t i) const {
+    Span s = tokens_[i];
+    if (i >= tokens_.gap()) {
+        s.begin = text_.size() - s.begin;
+        s.end = text_.size() - s.end;
+    }
+    return s;
+}
+
+Token IncrementalLexer::token(size_t i) const {
+    Span s = span(i);
+    // 文本间隙总在单词分界上，单词不会跨过间隙
+    std::string_view raw(text_.at(s.begin), s.end - s.begin);
+    if (s.kind == TokenKind::STRCON || s.kind == TokenKind::CHARCON) {
+        char quote = raw[0];
+        raw.remove_prefix(1);
+        if (!raw.empty() && raw.back() == quote) raw.remove_suffix(1);
+    }
+    return Token{s.kind, raw};
+}
+
+IncrementalLexer::Change IncrementalLexer::edit(size_t offset, size_t removed, std::string_view inserted) {
+    const size_t oldLength = text_.size();
+    offset = std::min(offset, oldLength);
+    removed = std::min(removed, oldLength - offset);
+
+    // 1. 第一个受影响的单词：结尾不早于 offset 的第一个单词。
+    //    单词结束时还看过结尾处的一个字符（如 "<" 后是否有 "="），结尾正好在 offset 的单词也可能改变
+    size_t lo = 0, hi = tokens_.size();
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (span(mid).end < offset) lo = mid + 1;
+        else hi = mid;
+    }
+    Change change;
+    change.first = lo;
+    size_t restart = lo == 0 ? 0 : span(lo - 1).end;
+
+    // 2. 单词的间隙移到 first。跨过间隙的单词在"到开头的偏移"和"到末尾的距离"之间换算（两个方向的换算相同）
+    tokens_.moveGap(change.first, [&](Span& s) {
+        s.begin = oldLength - s.begin;
+        s.end = oldLength - s.end;
+    });
+
+    // 3. 修改源文件，再把文本间隙移到 restart，之后的内容在内存中连续
+    text_.moveGap(offset);
+    text_.eraseAfterGap(removed);
+    text_.insert(inserted.data(), inserted.size());
+    text_.moveGap(restart);
+
+    // 4. 重新分析，直到与编辑之后的旧单词对齐
+    relex(restart, offset + inserted.size(), change);
+    return change;
+}
+
+void IncrementalLexer::relex(size_t restart, size_t syncFrom, Change& change) {
+    const size_t length = text_.size();
+    const char* base = text_.afterGap();
+    Lexer lexer(base, length - restart);
+    Token tok;
+    while (lexer.next(tok)) {
+        const char* rawBegin = tok.text.data();
+        if (tok.kind == TokenKind::STRCON || tok.kind == TokenKind::CHARCON) rawBegin--;
+        Span s{tok.kind, restart + (size_t)(rawBegin - base), restart + (size_t)(lexer.position() - base)};
+        if (s.begin >= syncFrom) {
+            // 间隙后的旧单词记录的是到末尾的距离，编辑之后的部分不变，可以直接与新单词比较
+            size_t distance = length - s.begin;
+            while (tokens_.afterGapCount() > 0 && tokens_[tokens_.gap()].begin > distance) {
+                tokens_.eraseAfterGap(1);
+                change.removed++;
+            }
+            // 从同一位置开始分析，之后的单词都相同
+            if (tokens_.afterGapCount() > 0 && tokens_[tokens_.gap()].begin == distance) return;
+        }
+        tokens_.insert(s);
+        change.inserted++;
+    }
+    change.removed += tokens_.afterGapCount();
+    tokens_.eraseAfterGap(tokens_.afterGapCount());
+}
@@ -0,0 +1,115 @@
+#ifndef LEXICAL_INCREMENTAL_LEXER_H
+#define LEXICAL_INCREMENTAL_LEXER_H
+
+// 增量词法分析：保存源文件和上一次的单词序列（带字节偏移），编辑后只从编辑前最近的单词分界开始重新分析，
+// 直到新单词与旧单词在编辑之后的同一位置开始（之后的单词必然相同），并给出被替换的单词范围。
+// 源文件和单词序列都放在间隙缓冲区中，间隙停在上一次编辑的位置：
+//   - 源文件：编辑只搬动间隙附近的字节；
+//   - 单词：间隙前的单词记录到文件开头的偏移，间隙后的单词记录到文件末尾的距离，
+//     编辑不改变两边已有的记录，只有跨过间隙的单词需要换算。
+// 所以一次编辑的代价取决于编辑的大小和与上一次编辑的距离，与文件大小无关。
+// 重新分析使用手写的词法分析器（lexer.h），结果与整体分析相同。
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "token.h"
+
+// 间隙缓冲区：元素按下标排列，中间有一段空位（间隙），在间隙处插入、删除不需要搬动其他元素
+template <class T>
+class GapBuffer {
+public:
+    size_t size() const { return data_.size() - (gapEnd_ - gapStart_); }
+    // 间隙的位置：间隙前的元素个数
+    size_t gap() const { return gapStart_; }
+    // 间隙后的元素个数
+    size_t afterGapCount() const { return data_.size() - gapEnd_; }
+
+    const T& operator[](size_t i) const { return *at(i); }
+    const T* at(size_t i) const { return data_.data() + (i < gapStart_ ? i : i + gapEnd_ - gapStart_); }
+    // 间隙后的元素在内存中连续
+    const T* afterGap() const { return data_.data() + gapEnd_; }
+
+    // 把间隙移到 pos。跨过间隙的每个元素调用 cross(x)
+    template <class Cross>
+    void moveGap(size_t pos, Cross cross) {
+        while (gapStart_ > pos) {
+            T x = data_[--gapStart_];
+            cross(x);
+            data_[--gapEnd_] = x;
+        }
+        while (gapStart_ < pos) {
+            T x = data_[gapEnd_++];
+            cross(x);
+            data_[gapStart_++] = x;
+        }
+    }
+    void moveGap(size_t pos) {
+        moveGap(pos, [](T&) {});
+    }
+
+    // 在间隙前插入
+    void insert(const T& x) {
+        if (gapStart_ == gapEnd_) grow(1);
+        data_[gapStart_++] = x;
+    }
+    void insert(const T* p, size_t n) {
+        if (gapEnd_ - gapStart_ < n) grow(n);
+        std::copy(p, p + n, data_.begin() + gapStart_);
+        gapStart_ += n;
+    }
+    // 删除间隙后的 n 个元素
+    void eraseAfterGap(size_t n) { gapEnd_ += n; }
+
+private:
+    void grow(size_t n) {
+        size_t tail = afterGapCount();
+        size_t oldSize = data_.size();
+        data_.resize(std::max(oldSize * 2, oldSize + n) + 64);
+        std::move_backward(data_.begin() + gapEnd_, data_.begin() + oldSize, data_.end());
+        gapEnd_ = data_.size() - tail;
+    }
+
+    std::vector<T> data_;
+    size_t gapStart_ = 0;
+    size_t gapEnd_ = 0;
+};
+
+class IncrementalLexer {
+public:
+    // 单词在源文件中的原始范围 [begin, end)，字符串 / 字符常量包括引号
+    struct Span {
+        TokenKind kind;
+        size_t begin, end;
+    };
+
+    // 一次编辑的结果：旧单词 [first, first + removed) 被替换为新单词 [first, first + inserted)
+    struct Change {
+        size_t first = 0;
+        size_t removed = 0;
+        size_t inserted = 0;
+    };
+
+    explicit IncrementalLexer(std::string_view source);
+
+    // 把源文件 [offset, offset + removed) 替换为 inserted，超出文件的部分截掉
+    Change edit(size_t offset, size_t removed, std::string_view inserted);
+
+    size_t length() const { return text_.size(); }
+    size_t tokenCount() const { return tokens_.size(); }
+    Span span(size_t i) const;
+    // 第 i 个单词，内容指向内部缓冲区，下一次编辑后失效
+    Token token(size_t i) const;
+
+private:
+    // 从源文件的位置 restart（单词分界，必须在文本间隙处）开始分析，新单词插入单词间隙；
+    // 新单词在 syncFrom 及之后开始、且与间隙后的某个旧单词开始位置相同时停止，在它之前开始的旧单词删除
+    void relex(size_t restart, size_t syncFrom, Change& change);
+
+    GapBuffer<char> text_;
+    GapBuffer<Span> tokens_; // 间隙后的 begin / end 存放到文件末尾的距离
+};
+
+#endif
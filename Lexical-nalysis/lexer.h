@@ -0,0 +1,101 @@
+#ifndef LEXICAL_LEXER_H
+#define LEXICAL_LEXER_H
+
+// 手写的词法分析器：按单词的首字符分情况处理，连续段用 char_scan 的向量内核扫描
+
+#include <string_view>
+
+#include "char_scan.h"
+#include "token.h"
+
+// 在内存中的源文件上逐个取单词
+class Lexer {
+public:
+    Lexer(const char* data, size_t size) : p_(data), end_(data + size) {}
+
+    // 取下一个单词，到达文件末尾时返回 false
+    bool next(Token& tok) {
+        while (p_ < end_) {
+            unsigned char ch = (unsigned char)*p_;
+            uint8_t cls = charscan::classTable[ch];
+            // 1. 跳过空白字符
+            if (cls & charscan::SPACE) {
+                p_ = charscan::skipClass(p_ + 1, end_, charscan::SPACE);
+                continue;
+            }
+
+            // 2. 标识符或保留字（字母或下划线开头）
+            if ((cls & charscan::IDENT) && !(cls & charscan::DIGIT)) {
+                const char* begin = p_;
+                // 继续读取直到不是字母、数字或下划线
+                p_ = charscan::skipClass(p_ + 1, end_, charscan::IDENT);
+                tok.text = std::string_view(begin, p_ - begin);
+                // 查完美哈希表判断是保留字还是标识符
+                tok.kind = keywordKind(tok.text);
+                return true;
+            }
+            // 3. 整型常量
+            if (cls & charscan::DIGIT) {
+                const char* begin = p_;
+                p_ = charscan::skipClass(p_ + 1, end_, charscan::DIGIT);
+                tok.kind = TokenKind::INTCON;
+                tok.text = std::string_view(begin, p_ - begin);
+                return true;
+            }
+            // 4. 字符串常量 / 5. 字符常量：读取直到遇到下一个同样的引号，没有时读到文件末尾
+            // （题目样例似乎不包含转义字符处理，直接取引号内的内容）
+            if (ch == '"' || ch == '\'') {
+                const char* begin = ++p_;
+                p_ = charscan::findChar(p_, end_, (char)ch);
+                tok.kind = ch == '"' ? TokenKind::STRCON : TokenKind::CHARCON;
+                tok.text = std::string_view(begin, p_ - begin);
+                if (p_ < end_) p_++;
+                return true;
+            }
+            // 6. 运算符和界符
+            p_++;
+            bool eq = p_ < end_ && *p_ == '=';
+            switch (ch) {
+                case '<': return twoChar(tok, eq, TokenKind::LEQ, TokenKind::LSS);
+                case '>': return twoChar(tok, eq, TokenKind::GEQ, TokenKind::GRE);
+                case '=': return twoChar(tok, eq, TokenKind::EQL, TokenKind::ASSIGN);
+                case '!':
+                    // 单独的 '!' 不是合法单词，直接丢弃
+                    if (!eq) continue;
+                    return twoChar(tok, eq, TokenKind::NEQ, TokenKind::NONE);
+                default:
+                    // 单字符符号查表，其他字符丢弃
+                    if (singleCharKind[ch] != TokenKind::NONE) return single(tok, singleCharKind[ch]);
+                    break;
+            }
+        }
+        return false;
+    }
+
+    // 当前位置：刚取出的单词（含结束引号）之后
+    const char* position() const { return p_; }
+
+private:
+    // 刚读过的一个字符本身就是单词
+    bool single(Token& tok, TokenKind kind) {
+        tok.kind = kind;
+        tok.text = std::string_view(p_ - 1, 1);
+        return true;
+    }
+
+    // 后面跟 '=' 时组成双字符运算符，否则是单字符运算符
+    bool twoChar(Token& tok, bool eq, TokenKind kindWithEq, TokenKind kindAlone) {
+        if (eq) {
+            tok.kind = kindWithEq;
+            tok.text = std::string_view(p_ - 1, 2);
+            p_++;
+            return true;
+        }
+        return single(tok, kindAlone);
+    }
+
+    const char* p_;
+    const char* end_;
+};
+
+#endif
@@ -0,0 +1,374 @@
+#include "lexer_generator.h"
+
+#include <algorithm>
+#include <bitset>
+#include <map>
+#include <memory>
+
+#include "automata.h"
+
+using namespace std;
+
+namespace {
+
+// 规则正规式的语法树
+struct RegexNode {
+    enum Kind { CHARSET, CONCAT, UNION, STAR, PLUS, OPTIONAL, EMPTY } kind;
+    bitset<256> chars; // CHARSET 匹配的字节
+    vector<unique_ptr<RegexNode>> children;
+
+    explicit RegexNode(Kind k) : kind(k) {}
+};
+
+// 递归下降解析规则正规式：
+//   union  ::= concat { '|' concat }
+//   concat ::= { repeat }
+//   repeat ::= atom { '*' | '+' | '?' }
+//   atom   ::= 字符 | '\' 字符 | '[' 字符类 ']' | '(' union ')'
+class RegexParser {
+public:
+    explicit RegexParser(const string& s) : s_(s) {}
+
+    unique_ptr<RegexNode> parse(string& error) {
+        unique_ptr<RegexNode> node = parseUnion();
+        if (error_.empty() && pos_ < s_.size()) error_ = "多余的 ')'";
+        if (!error_.empty()) {
+            error = error_;
+            return nullptr;
+        }
+        return node;
+    }
+
+private:
+    unique_ptr<RegexNode> parseUnion() {
+        unique_ptr<RegexNode> first = parseConcat();
+        if (pos_ >= s_.size() || s_[pos_] != '|') return first;
+        unique_ptr<RegexNode> node(new RegexNode(RegexNode::UNION));
+        node->children.push_back(move(first));
+        while (pos_ < s_.size() && s_[pos_] == '|') {
+            pos_++;
+            node->children.push_back(parseConcat());
+        }
+        return node;
+    }
+
+    unique_ptr<RegexNode> parseConcat() {
+        unique_ptr<RegexNode> node(new RegexNode(RegexNode::CONCAT));
+        while (pos_ < s_.size() && s_[pos_] != '|' && s_[pos_] != ')' && error_.empty()) {
+            node->children.push_back(parseRepeat());
+        }
+        if (node->children.empty()) return unique_ptr<RegexNode>(new RegexNode(RegexNode::EMPTY));
+        if (node->children.size() == 1) return move(node->children[0]);
+        return node;
+    }
+
+    unique_ptr<RegexNode> parseRepeat() {
+        unique_ptr<RegexNode> node = parseAtom();
+        while (pos_ < s_.size() && (s_[pos_] == '*' || s_[pos_] == '+' || s_[pos_] == '?')) {
+            char op = s_[pos_++];
+            RegexNode::Kind kind = op == '*' ? RegexNode::STAR : op == '+' ? RegexNode::PLUS : RegexNode::OPTIONAL;
+            unique_ptr<RegexNode> wrapped(new RegexNode(kind));
+            wrapped->children.push_back(move(node));
+            node = move(wrapped);
+        }
+        return node;
+    }
+
+    unique_ptr<RegexNode> parseAtom() {
+        char c = s_[pos_++];
+        if (c == '(') {
+            unique_ptr<RegexNode> node = parseUnion();
+            if (pos_ >= s_.size() || s_[pos_] != ')') {
+                if (error_.empty()) error_ = "缺少 ')'";
+                return node;
+            }
+            pos_++;
+            return node;
+        }
+        unique_ptr<RegexNode> node(new RegexNode(RegexNode::CHARSET));
+        if (c == '*' || c == '+' || c == '?') {
+            error_ = string("运算符 ") + c + " 前没有操作数";
+        } else if (c == '[') {
+            parseClass(node->chars);
+        } else if (c == '\\') {
+            node->chars.set((unsigned char)escaped());
+        } else {
+            node->chars.set((unsigned char)c);
+        }
+        return node;
+    }
+
+    // [...]，pos_ 在 '[' 之后
+    void parseClass(bitset<256>& chars) {
+        bool negate = pos_ < s_.size() && s_[pos_] == '^';
+        if (negate) pos_++;
+        bool first = true;
+        while (pos_ < s_.size() && (s_[pos_] != ']' || first)) {
+            first = false;
+            unsigned char lo = (unsigned char)(s_[pos_] == '\\' ? (pos_++, escaped()) : s_[pos_++]);
+            unsigned char hi = lo;
+            if (pos_ + 1 < s_.size() && s_[pos_] == '-' && s_[pos_ + 1] != ']') {
+                pos_++;
+                hi = (unsigned char)(s_[pos_] == '\\' ? (pos_++, escaped()) : s_[pos_++]);
+            }
+            for (int b = lo; b <= hi; b++) chars.set(b);
+        }
+        if (pos_ >= s_.size()) {
+            error_ = "缺少 ']'";
+            return;
+        }
+        pos_++;
+        if (negate) chars.flip();
+        if (chars.none()) error_ = "空的字符类";
+    }
+
+    // '\' 之后的字符，pos_ 在 '\' 之后
+    char escaped() {
+        if (pos_ >= s_.size()) {
+            error_ = "'\\' 后缺少字符";
+            return '\\';
+        }
+        char c = s_[pos_++];
+        switch (c) {
+            case 'n': return '\n';
+            case 't': return '\t';
+            case 'r': return '\r';
+            case 'v': return '\v';
+            case 'f': return '\f';
+            default: return c;
+        }
+    }
+
+    const string& s_;
+    size_t pos_ = 0;
+    string error_;
+};
+
+void collectCharsets(const RegexNode& node, vector<const bitset<256>*>& sets) {
+    if (node.kind == RegexNode::CHARSET) sets.push_back(&node.chars);
+    for (const auto& child : node.children) collectCharsets(*child, sets);
+}
+
+// 字符类 c 在库的正规式中用的符号：避开库的运算符 | * . ( ) 和空串 '~'
+vector<char> classSymbols() {
+    vector<char> symbols;
+    for (int c = 0x21; c < 0xFF; c++) {
+        if (c == '|' || c == '*' || c == '.' || c == '(' || c == ')' || c == '~' || c == 0x7F) continue;
+        symbols.push_back((char)c);
+    }
+    return symbols;
+}
+
+// 把语法树写成 automata 库的正规式（只有 | * ( ) 和 ~），每个字符类写成一个符号
+string toLibraryRegex(const RegexNode& node, const uint8_t* classOf, const vector<char>& symbols) {
+    switch (node.kind) {
+        case RegexNode::CHARSET: {
+            vector<bool> used(symbols.size(), false);
+            string alternatives;
+            int count = 0;
+            for (int b = 0; b < 256; b++) {
+                if (!node.chars.test(b) || used[classOf[b]]) continue;
+                used[classOf[b]] = true;
+                if (count++) alternatives += '|';
+                alternatives += symbols[classOf[b]];
+            }
+            if (count == 0) return "";
+            return count == 1 ? alternatives : "(" + alternatives + ")";
+        }
+        case RegexNode::CONCAT: {
+            string s;
+            for (const auto& child : node.children) s += "(" + toLibraryRegex(*child, classOf, symbols) + ")";
+            return s;
+        }
+        case RegexNode::UNION: {
+            string s;
+            for (size_t i = 0; i < node.children.size(); i++) {
+                if (i) s += '|';
+                s += toLibraryRegex(*node.children[i], classOf, symbols);
+            }
+            return "(" + s + ")";
+        }
+        case RegexNode::STAR:
+            return "(" + toLibraryRegex(*node.children[0], classOf, symbols) + ")*";
+        case RegexNode::PLUS: {
+            string child = "(" + toLibraryRegex(*node.children[0], classOf, symbols) + ")";
+            return child + child + "*";
+        }
+        case RegexNode::OPTIONAL:
+            return "(" + toLibraryRegex(*node.children[0], classOf, symbols) + "|~)";
+        case RegexNode::EMPTY:
+        default:
+            return "~";
+    }
+}
+
+} // namespace
+
+bool buildLexerTable(const vector<TokenRule>& rules, LexerTable& table, string& error) {
+    table = LexerTable();
+
+    // 1. 解析各规则的正规式
+    vector<unique_ptr<RegexNode>> trees;
+    for (const TokenRule& rule : rules) {
+        unique_ptr<RegexNode> tree = RegexParser(rule.regex).parse(error);
+        if (!tree) {
+            error = string("规则 ") + rule.regex + "：" + error;
+            return false;
+        }
+        trees.push_back(move(tree));
+    }
+
+    // 2. 字符类压缩：在所有规则中出现情况完全相同的字节归为一类
+    vector<const bitset<256>*> sets;
+    for (const auto& tree : trees) collectCharsets(*tree, sets);
+    map<vector<bool>, uint8_t> signatureToClass;
+    vector<char> symbols = classSymbols();
+    for (int b = 0; b < 256; b++) {
+        vector<bool> signature(sets.size());
+        for (size_t i = 0; i < sets.size(); i++) signature[i] = sets[i]->test(b);
+        auto it = signatureToClass.find(signature);
+        if (it == signatureToClass.end()) {
+            if (signatureToClass.size() >= symbols.size()) {
+                error = "字符类过多";
+                return false;
+            }
+            it = signatureToClass.insert({signature, (uint8_t)signatureToClass.size()}).first;
+        }
+        table.classOf[b] = it->second;
+    }
+    table.classCount = (uint32_t)signatureToClass.size();
+
+    // 3. 各规则分别构造NFA，再用一个新初态经空边连到各规则的初态。
+    //    规则按优先级排序后的名次作为终态的标记，标记小的优先
+    vector<size_t> byPriority(rules.size());
+    for (size_t i = 0; i < rules.size(); i++) byPriority[i] = i;
+    stable_sort(byPriority.begin(), byPriority.end(),
+                [&](size_t a, size_t b) { return rules[a].priority < rules[b].priority; });
+
+    vector<automata::AutomatonData> parts(rules.size());
+    uint32_t total = 1;
+    for (size_t rank = 0; rank < byPriority.size(); rank++) {
+        size_t i = byPriority[rank];
+        string libraryRegex = toLibraryRegex(*trees[i], table.classOf, symbols);
+        if (!automata::buildNFA(libraryRegex, automata::NFAConstruction::Thompson, parts[rank], error)) {
+            error = string("规则 ") + rules[i].regex + "：" + error;
+            return false;
+        }
+        total += parts[rank].stateCount();
+    }
+
+    automata::AutomatonData nfa;
+    vector<uint32_t> nfaTags(total, automata::NO_TAG);
+    nfa.startState = nfa.addState("X", false);
+    vector<uint32_t> base(parts.size());
+    for (size_t rank = 0, next = 1; rank < parts.size(); rank++) {
+        base[rank] = (uint32_t)next;
+        nfa.addEdge(automata::EPSILON_CHAR, base[rank] + parts[rank].startState);
+        next += parts[rank].stateCount();
+    }
+    for (size_t rank = 0; rank < parts.size(); rank++) {
+        const automata::AutomatonData& part = parts[rank];
+        for (uint32_t s = 0; s < part.stateCount(); s++) {
+            uint32_t id = nfa.addState(to_string(rank) + ":" + part.name(s), part.isAccepting(s));
+            if (part.isAccepting(s)) nfaTags[id] = (uint32_t)rank;
+            for (uint32_t e = part.edgeOffsets[s]; e < part.edgeOffsets[s + 1]; e++) {
+                nfa.addEdge(part.symbol(e), base[rank] + part.edgeTargets[e]);
+            }
+        }
+    }
+
+    // 4. 确定化、按标记最小化
+    vector<uint32_t> dfaTags, minTags;
+    automata::AutomatonData dfa = automata::determinize(nfa, nfaTags, dfaTags);
+    automata::AutomatonData minimal = automata::minimize(dfa, dfaTags, minTags);
+    if (minTags[minimal.startState] != automata::NO_TAG) {
+        error = string("规则 ") + rules[byPriority[minTags[minimal.startState]]].regex + " 可以匹配空串";
+        return false;
+    }
+    if (minimal.stateCount() + 1 > 0xFFFF) {
+        error = "状态过多";
+        return false;
+    }
+
+    // 5. 压缩表：最小DFA的状态 s 在表中编号为 s + 1，0 留给死状态
+    int symbolToClass[256];
+    fill(symbolToClass, symbolToClass + 256, -1);
+    for (size_t c = 0; c < table.classCount; c++) symbolToClass[(unsigned char)symbols[c]] = (int)c;
+
+    const uint32_t k = table.classCount;
+    table.stateCount = minimal.stateCount() + 1;
+    table.start = (uint16_t)(minimal.startState + 1);
+    table.next.assign((size_t)table.stateCount * k, 0);
+    table.accept.assign(table.stateCount, -1);
+    for (uint32_t s = 0; s < minimal.stateCount(); s++) {
+        for (uint32_t e = minimal.edgeOffsets[s]; e < minimal.edgeOffsets[s + 1]; e++) {
+            int c = symbolToClass[(unsigned char)minimal.symbol(e)];
+            table.next[(size_t)(s + 1) * k + c] = (uint16_t)(minimal.edgeTargets[e] + 1);
+        }
+        if (minTags[s] != automata::NO_TAG) table.accept[s + 1] = (int16_t)byPriority[minTags[s]];
+    }
+
+    // 6. 加速：找出自环上的字节集合正好是 char_scan 字符类（或其组合）、或只缺一个字节的状态
+    table.accel.assign(table.stateCount, StateAccel());
+    for (uint32_t s = 1; s < table.stateCount; s++) {
+        bitset<256> loop;
+        for (int b = 0; b < 256; b++) {
+            if (table.next[(size_t)s * k + table.classOf[b]] == s) loop.set(b);
+        }
+        if (loop.none()) continue;
+        if (loop.count() == 255) {
+            for (int b = 0; b < 256; b++) {
+                if (!loop.test(b)) table.accel[s].until = (int16_t)b;
+            }
+            continue;
+        }
+        for (uint8_t classes = 1; classes < 8; classes++) {
+            bool same = true;
+            for (int b = 0; b < 256 && same; b++) same = loop.test(b) == ((charscan::classTable[b] & classes) != 0);
+            if (same) {
+                table.accel[s].classes = classes;
+                break;
+            }
+        }
+    }
+
+    // 7. 带加速的状态重新编号到最后（死状态仍为 0），扫描时比较一次状态号就知道是否要加速；
+    //    每行补齐到 2 的幂项，表中直接存目标状态的行首（状态号 << shift），扫描时不必做乘法
+    auto hasAccel = [&](uint32_t s) { return table.accel[s].classes != 0 || table.accel[s].until >= 0; };
+    vector<uint32_t> order(1, 0);
+    for (uint32_t s = 1; s < table.stateCount; s++) {
+        if (!hasAccel(s)) order.push_back(s);
+    }
+    table.accelFrom = (uint32_t)order.size();
+    for (uint32_t s = 1; s < table.stateCount; s++) {
+        if (hasAccel(s)) order.push_back(s);
+    }
+    uint32_t shift = 0;
+    while ((1u << shift) < k) shift++;
+    if (((size_t)table.stateCount << shift) > 0x10000) {
+        error = "状态过多";
+        return false;
+    }
+    vector<uint16_t> newRow(table.stateCount);
+    for (uint32_t i = 0; i < table.stateCount; i++) newRow[order[i]] = (uint16_t)(i << shift);
+    vector<uint16_t> next((size_t)table.stateCount << shift, 0);
+    vector<int16_t> accept(next.size(), -1);
+    vector<StateAccel> accel(table.stateCount);
+    for (uint32_t i = 0; i < table.stateCount; i++) {
+        for (uint32_t c = 0; c < k; c++) next[((size_t)i << shift) + c] = newRow[table.next[(size_t)order[i] * k + c]];
+        accept[(size_t)i << shift] = table.accept[order[i]];
+        accel[i] = table.accel[order[i]];
+    }
+    table.shift = shift;
+    table.accelFrom <<= shift;
+    table.next = move(next);
+    table.accept = move(accept);
+    table.accel = move(accel);
+    table.start = newRow[table.start];
+
+    for (const TokenRule& rule : rules) {
+        table.kinds.push_back(rule.kind);
+        table.flags.push_back(rule.flags);
+    }
+    return true;
+}
@@ -0,0 +1,122 @@
+#ifndef LEXICAL_LEXER_GENERATOR_H
+#define LEXICAL_LEXER_GENERATOR_H
+
+// 表驱动的词法分析器生成器。
+// 每条单词规则是 正规式 + 类别码 + 优先级；各规则的正规式经 automata 库的
+// NFA → DFA → 最小化 得到一个DFA，终态带上所匹配规则的标记。
+// 结果是按字符类压缩的转移表，扫描时取最长匹配，长度相同时取优先级高的规则。
+// 增加一种单词只需要增加一条规则，不需要新的分支代码。
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "char_scan.h"
+#include "lexer.h"
+
+// 规则的附加处理
+const unsigned TOKEN_STRIP_QUOTES = 1; // 输出内容去掉首字符，以及与首字符相同的尾字符（引号）
+const unsigned TOKEN_KEYWORDS = 2;     // 匹配后查保留字的完美哈希表，是保留字时改用保留字的类别码
+
+// 单词规则。正规式语法：
+//   普通字符、\ 转义（\n \t \r \v \f 以及其他字符本身）、[...] 字符类（支持 a-z 区间和 ^ 取反）、
+//   | 并、* 闭包、+ 正闭包、? 可选、( ) 分组，连接省略不写
+struct TokenRule {
+    TokenKind kind;     // 类别码；NONE 表示匹配后丢弃（如空白）
+    const char* regex;
+    int priority;       // 匹配长度相同时取 priority 小的规则
+    unsigned flags = 0;
+};
+
+// 状态的加速方式：自环上的字节正好是 char_scan 的字符类（如标识符、空白的连续段），
+// 或除某个字节以外的全部字节（如字符串常量的内容）时，进入这个状态后整段输入用 char_scan 一次跳过，
+// 跳过之后的字节一定离开这个状态
+struct StateAccel {
+    uint8_t classes = 0; // 不为 0 时跳过属于这些字符类的字节
+    int16_t until = -1;  // 不为 -1 时跳到第一个等于 until 的字节
+};
+
+// 压缩后的转移表。每个状态占 next 中的一行，行宽补齐到 2 的幂，状态用行首下标（状态号 << shift）表示，
+// next[行首 + classOf[c]] 是目标状态的行首，扫描时不做乘法；状态 0 是死状态。
+// 带加速的状态编号排在最后，扫描时转移到的状态不小于 accelFrom 才查加速方式，其余状态的转移不多做判断
+struct LexerTable {
+    uint8_t classOf[256] = {0};
+    uint32_t classCount = 0;
+    uint32_t stateCount = 0;
+    uint32_t shift = 0;                   // 每行 1 << shift 项（不小于 classCount）
+    uint32_t accelFrom = 0;               // 第一个带加速的状态的行首，没有时等于 stateCount << shift
+    uint16_t start = 0;                   // 初态的行首
+    std::vector<uint16_t> next;
+    std::vector<int16_t> accept;          // 以行首为下标：该状态接受的规则下标，-1 表示不是终态
+    std::vector<StateAccel> accel;        // 以状态号为下标：各状态的加速方式
+    std::vector<TokenKind> kinds;         // 规则下标 -> 类别码（NONE 表示丢弃）
+    std::vector<unsigned> flags;          // 规则下标 -> 附加处理
+};
+
+// 由规则生成转移表；规则不合法（正规式错误、能匹配空串、字符类过多）时返回 false
+bool buildLexerTable(const std::vector<TokenRule>& rules, LexerTable& table, std::string& error);
+
+// 由转移表驱动的扫描：最长匹配；没有任何规则能匹配时丢弃一个字符（与手写版本对非法字符的处理相同）
+class TableLexer {
+public:
+    TableLexer(const LexerTable& table, const char* data, size_t size)
+        : t_(table), p_(data), end_(data + size) {}
+
+    bool next(Token& tok) {
+        const uint16_t* next = t_.next.data();
+        const int16_t* accept = t_.accept.data();
+        const uint8_t* classOf = t_.classOf;
+        const uint32_t accelFrom = t_.accelFrom;
+        const TokenKind* kinds = t_.kinds.data();
+        while (p_ < end_) {
+            const char* begin = p_;
+            const char* q = p_;
+            const char* lastEnd = nullptr;
+            int lastRule = -1;
+            uint32_t s = t_.start;
+            while (q < end_) {
+                s = next[s + classOf[(unsigned char)*q]];
+                if (s == 0) break;
+                q++;
+                if (s >= accelFrom) q = skipLoop(s, q);
+                if (accept[s] >= 0) {
+                    lastRule = accept[s];
+                    lastEnd = q;
+                }
+            }
+            if (lastRule < 0) {
+                p_ = begin + 1;
+                continue;
+            }
+            p_ = lastEnd;
+            TokenKind kind = kinds[lastRule];
+            if (kind == TokenKind::NONE) continue;
+            unsigned flags = t_.flags[lastRule];
+            tok.kind = kind;
+            tok.text = std::string_view(begin, lastEnd - begin);
+            if (flags & TOKEN_KEYWORDS) tok.kind = keywordKind(tok.text);
+            if (flags & TOKEN_STRIP_QUOTES) {
+                char quote = tok.text[0];
+                tok.text.remove_prefix(1);
+                if (!tok.text.empty() && tok.text.back() == quote) tok.text.remove_suffix(1);
+            }
+            return true;
+        }
+        return false;
+    }
+
+private:
+    // 刚进入带加速的状态（行首为 s）：跳过 q 开始在自环上的整段字节
+    const char* skipLoop(uint32_t s, const char* q) const {
+        const StateAccel& accel = t_.accel[s >> t_.shift];
+        if (accel.classes) return charscan::skipClass(q, end_, accel.classes);
+        return charscan::findChar(q, end_, (char)accel.until);
+    }
+
+    const LexerTable& t_;
+    const char* p_;
+    const char* end_;
+};
+
+#endif
@@ -1,156 +1,164 @@
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <cctype>
-#include <map>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include "char_scan.h"
+#include "source_io.h"
+#include "lexer.h"
+#include "lexer_generator.h"
+#include "incremental_lexer.h"
+#include "parallel_lex.h"
 
 using namespace std;
-// 关键字映射表
-map<string, string> keywords = {
-    {"const", "CONSTTK"}, {"int", "INTTK"}, {"char", "CHARTK"},
-    {"void", "VOIDTK"}, {"main", "MAINTK"}, {"if", "IFTK"},
-    {"else", "ELSETK"}, {"do", "DOTK"}, {"while", "WHILETK"},
-    {"for", "FORTK"}, {"scanf", "SCANFTK"}, {"printf", "PRINTFTK"},
-    {"return", "RETURNTK"}
+
+// 单词规则（同样长时取 priority 小的）。保留字不单独写规则：标识符匹配后查保留字的完美哈希表，
+// 这样DFA不必为保留字的前缀分出状态，标识符的整段都能加速跳过。
+// 字符串/字符常量的结束引号可以没有（读到文件末尾为止），输出时去掉引号；空白匹配后丢弃
+using K = TokenKind;
+const vector<TokenRule> tokenRules = {
+    {K::IDENFR, "[A-Za-z_][A-Za-z0-9_]*", 1, TOKEN_KEYWORDS},
+    {K::INTCON, "[0-9]+", 1},
+    {K::STRCON, "\"[^\"]*\"?", 1, TOKEN_STRIP_QUOTES},
+    {K::CHARCON, "'[^']*'?", 1, TOKEN_STRIP_QUOTES},
+    {K::LSS, "<", 1}, {K::LEQ, "<=", 1}, {K::GRE, ">", 1}, {K::GEQ, ">=", 1},
+    {K::EQL, "==", 1}, {K::NEQ, "!=", 1}, {K::ASSIGN, "=", 1},
+    {K::PLUS, "\\+", 1}, {K::MINU, "-", 1}, {K::MULT, "\\*", 1}, {K::DIV, "/", 1},
+    {K::SEMICN, ";", 1}, {K::COMMA, ",", 1},
+    {K::LPARENT, "\\(", 1}, {K::RPARENT, "\\)", 1},
+    {K::LBRACK, "\\[", 1}, {K::RBRACK, "]", 1},
+    {K::LBRACE, "{", 1}, {K::RBRACE, "}", 1},
+    {K::NONE, "[ \\t\\n\\v\\f\\r]+", 1},
 };
 
-// 判断是否为单纯的单字符符号
-bool isSingleCharSymbol(char c) {
-    return string("+-*/;,()[]{}").find(c) != string::npos;
+// 逐个取单词，每个单词输出一行：类别码 单词内容
+template <class LexerType>
+void writeTokens(LexerType& lexer, OutputBuffer& out) {
+    Token tok;
+    while (lexer.next(tok)) {
+        out.write(tokenName(tok.kind));
+        out.put(' ');
+        out.write(tok.text);
+        out.put('\n');
+    }
+}
+
+// 比较手写版本与表驱动版本的吞吐量：各自把源文件完整扫描若干遍
+void runBenchmark(const SourceFile& source, const LexerTable& table) {
+    size_t rounds = source.size() == 0 ? 1 : max<size_t>(1, (64u << 20) / source.size());
+    auto measure = [&](auto makeLexer) {
+        size_t tokens = 0;
+        auto t0 = chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; r++) {
+            auto lexer = makeLexer();
+            Token tok;
+            while (lexer.next(tok)) tokens++;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        return make_pair(tokens / rounds, (double)source.size() * rounds / seconds / (1 << 20));
+    };
+    auto hand = measure([&] { return Lexer(source.data(), source.size()); });
+    auto generated = measure([&] { return TableLexer(table, source.data(), source.size()); });
+    cout << "bytes: " << source.size() << ", rounds: " << rounds << ", scan kernel: "
+         << charscan::kernelName(charscan::activeKernel()) << ", tokens: " << hand.first;
+    if (generated.first != hand.first) cout << " (table: " << generated.first << ")";
+    cout << endl;
+    cout << "handwritten: " << hand.second << " MB/s" << endl;
+    cout << "table (" << table.stateCount << " states, " << table.classCount << " classes): "
+         << generated.second << " MB/s (x" << generated.second / hand.second << ")" << endl;
 }
 
-int main() {
-    ifstream inFile("testfile.txt");
-    ofstream outFile("output.txt");
+int main(int argc, char* argv[]) {
+    // 默认用手写的词法分析器
+    // --table：改用由 tokenRules 生成的转移表做词法分析，输出相同（目前比手写的慢）
+    // --bench：比较两种词法分析器的吞吐量，不写 output.txt
+    // --scan <scalar|sse2|avx2>：字符类扫描使用的内核，默认按 CPU 选择最快的
+    // --parallel：把源文件切块，多线程并行分析，输出与顺序分析相同
+    // -j <线程数>：并行分析的线程数，默认使用全部核心
+    // --chunk <字节数>：并行分析切块的大小，默认 1 MB
+    // --edit <偏移> <删除长度> <插入内容>：分析后依次对源文件做这些编辑（可以重复），用增量词法分析更新单词，
+    //   输出编辑后的结果，每次编辑替换的单词范围打印到标准错误
+    bool useTable = false;
+    bool bench = false;
+    bool parallel = false;
+    unsigned threads = 0;
+    size_t chunkSize = 1 << 20;
+    struct Edit {
+        size_t offset, removed;
+        string inserted;
+    };
+    vector<Edit> edits;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--table") == 0) useTable = true;
+        else if (strcmp(argv[i], "--bench") == 0) bench = true;
+        else if (strcmp(argv[i], "--parallel") == 0) parallel = true;
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) threads = (unsigned)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc) chunkSize = (size_t)atoll(argv[++i]);
+        else if (strcmp(argv[i], "--edit") == 0 && i + 3 < argc) {
+            edits.push_back({(size_t)atoll(argv[i + 1]), (size_t)atoll(argv[i + 2]), argv[i + 3]});
+            i += 3;
+        }
+        else if (strcmp(argv[i], "--scan") == 0 && i + 1 < argc) {
+            string kernel = argv[++i];
+            if (kernel == "scalar") charscan::setKernel(charscan::Kernel::Scalar);
+            else if (kernel == "sse2") charscan::setKernel(charscan::Kernel::SSE2);
+            else if (kernel == "avx2") charscan::setKernel(charscan::Kernel::AVX2);
+        }
+    }
 
-    if (!inFile.is_open()) {
-        cerr << "无法打开输入文件 testfile.txt" << endl;
+    // 只在用到时生成转移表
+    LexerTable table;
+    string error;
+    if ((useTable || bench) && !buildLexerTable(tokenRules, table, error)) {
+        cerr << error << endl;
         return 1;
     }
 
-    char ch;
-    while (inFile.get(ch)) {
-        // 1. 跳过空白字符
-        if (isspace(ch)) {
-            continue;
-        }
+    OutputBuffer out;
+    if (!bench) out.open("output.txt");
 
-        // 2. 标识符或保留字
-        if (isalpha(ch) || ch == '_') {
-            string token = "";
-            token += ch;
-            // 继续读取直到不是字母、数字或下划线
-            while (inFile.get(ch)) {
-                if (isalnum(ch) || ch == '_') {
-                    token += ch;
-                } else {
-                    inFile.unget();
-                    break;
-                }
-            }
+    SourceFile source;
+    if (!source.open("testfile.txt")) {
+        cerr << "无法打开输入文件 testfile.txt" << endl;
+        return 1;
+    }
 
-            // 查表判断是保留字还是标识符
-            if (keywords.count(token)) {
-                outFile << keywords[token] << " " << token << endl;
-            } else {
-                outFile << "IDENFR " << token << endl;
-            }
-        }
-        // 3. 整型常量
-        else if (isdigit(ch)) {
-            string token;
-            token += ch;
-            while (inFile.get(ch)) {
-                if (isdigit(ch)) {
-                    token += ch;
-                } else {
-                    inFile.unget();
-                    break;
-                }
-            }
-            outFile << "INTCON " << token << endl;
-        }
-        // 4. 字符串常量
-        else if (ch == '"') {
-            string token;
-            // 读取直到遇到下一个双引号
-            while (inFile.get(ch)) {
-                if (ch == '"') break;
-                token += ch;
-            }
-            outFile << "STRCON " << token << endl;
+    if (bench) {
+        runBenchmark(source, table);
+        return 0;
+    }
+
+    if (!edits.empty()) {
+        IncrementalLexer lexer(source.text());
+        for (const Edit& e : edits) {
+            IncrementalLexer::Change change = lexer.edit(e.offset, e.removed, e.inserted);
+            cerr << "edit " << e.offset << ": tokens [" << change.first << ", " << change.first + change.removed
+                 << ") -> [" << change.first << ", " << change.first + change.inserted << ")" << endl;
         }
-        // 5. 字符常量
-        else if (ch == '\'') {
-            string token = "";
-            // 读取内容（题目样例似乎不包含转义字符处理，直接取单引号内的内容）
-            while (inFile.get(ch)) {
-                if (ch == '\'') break;
-                token += ch;
-            }
-            outFile << "CHARCON " << token << endl;
+        for (size_t i = 0; i < lexer.tokenCount(); i++) {
+            Token tok = lexer.token(i);
+            out.write(tokenName(tok.kind));
+            out.put(' ');
+            out.write(tok.text);
+            out.put('\n');
         }
-        // 6. 运算符和界符
-        else {
-            if (ch == '<') {
-                if (inFile.get(ch)) {
-                    if (ch == '=') outFile << "LEQ <=" << endl;
-                    else {
-                        inFile.unget();
-                        outFile << "LSS <" << endl;
-                    }
-                } else outFile << "LSS <" << endl;
-            }
-            else if (ch == '>') {
-                if (inFile.get(ch)) {
-                    if (ch == '=') outFile << "GEQ >=" << endl;
-                    else {
-                        inFile.unget();
-                        outFile << "GRE >" << endl;
-                    }
-                } else outFile << "GRE >" << endl;
-            }
-            else if (ch == '=') {
-                if (inFile.get(ch)) {
-                    if (ch == '=') outFile << "EQL ==" << endl;
-                    else {
-                        inFile.unget();
-                        outFile << "ASSIGN =" << endl;
-                    }
-                } else outFile << "ASSIGN =" << endl;
-            }
-            else if (ch == '!') {
-                if (inFile.get(ch)) {
-                    if (ch == '=') outFile << "NEQ !=" << endl;
-                    else {
-                        inFile.unget();
-                    }
-                }
-            }
-            else {
-                // 单字符符号处理
-                switch (ch) {
-                    case '+': outFile << "PLUS +" << endl; break;
-                    case '-': outFile << "MINU -" << endl; break;
-                    case '*': outFile << "MULT *" << endl; break;
-                    case '/': outFile << "DIV /" << endl; break;
-                    case ';': outFile << "SEMICN ;" << endl; break;
-                    case ',': outFile << "COMMA ," << endl; break;
-                    case '(': outFile << "LPARENT (" << endl; break;
-                    case ')': outFile << "RPARENT )" << endl; break;
-                    case '[': outFile << "LBRACK [" << endl; break;
-                    case ']': outFile << "RBRACK ]" << endl; break;
-                    case '{': outFile << "LBRACE {" << endl; break;
-                    case '}': outFile << "RBRACE }" << endl; break;
-                    default:
-                        break;
-                }
-            }
+    } else if (parallel) {
+        if (useTable) {
+            parallel_lex::lexParallel(source.data(), source.size(), threads, chunkSize,
+                                      [&](const char* p, size_t n) { return TableLexer(table, p, n); }, out);
+        } else {
+            parallel_lex::lexParallel(source.data(), source.size(), threads, chunkSize,
+                                      [](const char* p, size_t n) { return Lexer(p, n); }, out);
         }
+    } else if (useTable) {
+        TableLexer lexer(table, source.data(), source.size());
+        writeTokens(lexer, out);
+    } else {
+        Lexer lexer(source.data(), source.size());
+        writeTokens(lexer, out);
     }
-
-    inFile.close();
-    outFile.close();
     return 0;
 }
-
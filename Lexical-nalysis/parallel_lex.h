@@ -0,0 +1,127 @@
+#ifndef LEXICAL_PARALLEL_LEX_H
+#define LEXICAL_PARALLEL_LEX_H
+
+// 分块并行词法分析。
+// 单词之间，词法分析器唯一需要记住的状态是当前是否在字符串 / 字符常量里（没有转义和注释），
+// 这个状态只由引号决定，是一个 3 状态的自动机。把源文件切成块后：
+//   1. 并行：每块从 3 个可能的初始状态同时模拟引号自动机，得到块的状态转移函数（推测状态）；
+//   2. 串行：依次复合各块的转移函数，得到每块开头真实的引号状态（重新同步）；
+//   3. 并行：从块开头按真实状态向后找到第一个不在常量中的空白字符，作为块的分界。
+//      这个位置一定是单词之间的分界，各块从这里开始分析，结果与整体顺序分析相同；
+//   4. 并行：各块分别做词法分析并格式化输出，最后按块的顺序写出。
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "char_scan.h"
+#include "source_io.h"
+#include "token.h"
+
+namespace parallel_lex {
+
+enum QuoteState : uint8_t {
+    OUTSIDE = 0,   // 不在常量中
+    IN_STRING = 1, // 在 "..." 中
+    IN_CHAR = 2    // 在 '...' 中
+};
+
+inline uint8_t quoteStep(uint8_t state, char c) {
+    if (c == '"' && state != IN_CHAR) return state == OUTSIDE ? IN_STRING : OUTSIDE;
+    if (c == '\'' && state != IN_STRING) return state == OUTSIDE ? IN_CHAR : OUTSIDE;
+    return state;
+}
+
+// [p, end) 的引号状态转移函数：result[s] 为从状态 s 开始、走完这一段后的状态
+inline std::array<uint8_t, 3> quoteTransitions(const char* p, const char* end) {
+    std::array<uint8_t, 3> s = {OUTSIDE, IN_STRING, IN_CHAR};
+    for (; p < end; p++) {
+        char c = *p;
+        if (c != '"' && c != '\'') continue;
+        for (auto& state : s) state = quoteStep(state, c);
+    }
+    return s;
+}
+
+// 从 p 开始（此处引号状态为 state）找第一个不在常量中的空白字符，没有时返回 end
+inline const char* findBoundary(const char* p, const char* end, uint8_t state) {
+    for (; p < end; p++) {
+        char c = *p;
+        if (state == OUTSIDE && (charscan::classTable[(unsigned char)c] & charscan::SPACE)) return p;
+        state = quoteStep(state, c);
+    }
+    return end;
+}
+
+// 用 threads 个线程执行 fn(0 .. count-1)
+template <class Fn>
+void parallelFor(size_t count, unsigned threads, Fn fn) {
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i; (i = next.fetch_add(1)) < count;) fn(i);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+}
+
+// 一个单词的输出行：类别码 单词内容
+inline void appendToken(std::string& out, const Token& tok) {
+    std::string_view name = tokenName(tok.kind);
+    out.append(name.data(), name.size());
+    out += ' ';
+    out.append(tok.text.data(), tok.text.size());
+    out += '\n';
+}
+
+// 并行分析 [data, data + size)，按顺序写入 out。makeLexer(p, n) 返回分析 [p, p + n) 的词法分析器。
+// threads 为 0 时使用全部核心；chunkSize 为切块的大小（字节）
+template <class MakeLexer>
+void lexParallel(const char* data, size_t size, unsigned threads, size_t chunkSize, MakeLexer makeLexer,
+                 OutputBuffer& out) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    chunkSize = std::max<size_t>(chunkSize, 1);
+    const size_t chunks = std::max<size_t>(1, (size + chunkSize - 1) / chunkSize);
+    auto chunkStart = [&](size_t k) { return data + std::min(size, k * chunkSize); };
+
+    // 1. 各块的引号状态转移函数
+    std::vector<std::array<uint8_t, 3>> transitions(chunks);
+    parallelFor(chunks, threads, [&](size_t k) { transitions[k] = quoteTransitions(chunkStart(k), chunkStart(k + 1)); });
+
+    // 2. 复合得到各块开头的真实状态
+    std::vector<uint8_t> startState(chunks);
+    uint8_t state = OUTSIDE;
+    for (size_t k = 0; k < chunks; k++) {
+        startState[k] = state;
+        state = transitions[k][state];
+    }
+
+    // 3. 各块的分界：块开头之后第一个不在常量中的空白字符（第 0 块从文件开头开始）
+    std::vector<const char*> boundary(chunks + 1);
+    boundary[0] = data;
+    boundary[chunks] = data + size;
+    parallelFor(chunks - 1, threads, [&](size_t i) {
+        size_t k = i + 1;
+        boundary[k] = findBoundary(chunkStart(k), data + size, startState[k]);
+    });
+
+    // 4. 各块分别分析、格式化，按顺序写出
+    std::vector<std::string> text(chunks);
+    parallelFor(chunks, threads, [&](size_t k) {
+        const char* begin = boundary[k];
+        const char* end = std::max(boundary[k], boundary[k + 1]);
+        auto lexer = makeLexer(begin, (size_t)(end - begin));
+        Token tok;
+        while (lexer.next(tok)) appendToken(text[k], tok);
+    });
+    for (const std::string& s : text) out.write(s);
+}
+
+} // namespace parallel_lex
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef LEXICAL_SOURCE_IO_H
+#define LEXICAL_SOURCE_IO_H
+
+// 词法分析的输入输出缓冲：
+//   SourceFile   把整个源文件映射（或一次性读入）到内存，单词直接以 string_view 指向其中
+//   OutputBuffer 大块缓冲的输出，写满或析构时才真正写文件
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+class SourceFile {
+public:
+    SourceFile() {}
+    SourceFile(const SourceFile&) = delete;
+    SourceFile& operator=(const SourceFile&) = delete;
+    ~SourceFile() { close(); }
+
+    // 打开整个文件；不支持 mmap 或映射失败时整体读入
+    bool open(const char* path) {
+        close();
+#ifndef _WIN32
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                ::close(fd);
+#ifdef MADV_SEQUENTIAL
+                madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+                mapped_ = p;
+                data_ = (const char*)p;
+                size_ = (size_t)st.st_size;
+                return true;
+            }
+        }
+        ::close(fd);
+#endif
+        // 以文本方式读入，与 ifstream 的默认行为一致（Windows 下会转换换行符）
+        FILE* f = fopen(path, "r");
+        if (!f) return false;
+        char chunk[1 << 16];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) buffer_.insert(buffer_.end(), chunk, chunk + n);
+        fclose(f);
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        return true;
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    std::string_view text() const { return std::string_view(data_, size_); }
+
+private:
+    void close() {
+#ifndef _WIN32
+        if (mapped_) munmap(mapped_, size_);
+#endif
+        mapped_ = nullptr;
+        data_ = nullptr;
+        size_ = 0;
+        buffer_.clear();
+    }
+
+    void* mapped_ = nullptr;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<char> buffer_;
+};
+
+class OutputBuffer {
+public:
+    static const size_t CAPACITY = 1 << 20;
+
+    OutputBuffer() { buffer_.reserve(CAPACITY); }
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+    ~OutputBuffer() { close(); }
+
+    bool open(const char* path) {
+        close();
+        file_ = fopen(path, "w");
+        return file_ != nullptr;
+    }
+
+    // 不写文件，全部输出留在内存中，由 contents() 取出（如并行分析时各线程先各自输出，再按顺序合并）
+    void openMemory() {
+        close();
+        memory_ = true;
+    }
+
+    const std::string& contents() const { return buffer_; }
+
+    void write(std::string_view s) {
+        if (memory_) {
+            buffer_.append(s.data(), s.size());
+            return;
+        }
+        if (buffer_.size() + s.size() > CAPACITY) flush();
+        if (s.size() >= CAPACITY) {
+            // 超过缓冲区的大块直接写出
+            if (file_) fwrite(s.data(), 1, s.size(), file_);
+            return;
+        }
+        buffer_.append(s.data(), s.size());
+    }
+
+    void put(char c) {
+        if (buffer_.size() >= CAPACITY && !memory_) flush();
+        buffer_.push_back(c);
+    }
+
+    void flush() {
+        if (memory_) return;
+        if (file_ && !buffer_.empty()) fwrite(buffer_.data(), 1, buffer_.size(), file_);
+        buffer_.clear();
+    }
+
+    void close() {
+        flush();
+        if (file_) fclose(file_);
+        file_ = nullptr;
+        memory_ = false;
+        buffer_.clear();
+    }
+
+private:
+    FILE* file_ = nullptr;
+    bool memory_ = false;
+    std::string buffer_;
+};
+
+#endif
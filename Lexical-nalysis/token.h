@@ -0,0 +1,137 @@
+#ifndef LEXICAL_TOKEN_H
+#define LEXICAL_TOKEN_H
+
+// 单词的类别码和关键字表，都在编译期生成：
+//   TokenKind      类别码的枚举，tokenName 给出评测要求的名字（IDENFR、CONSTTK ...）
+//   keywordKind    13 个保留字的完美哈希：一次哈希、一次比较判断标识符是不是保留字
+//   singleCharKind 单字符界符的 256 项表
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+enum class TokenKind : uint8_t {
+    IDENFR, INTCON, CHARCON, STRCON,
+    CONSTTK, INTTK, CHARTK, VOIDTK, MAINTK, IFTK, ELSETK, DOTK, WHILETK, FORTK, SCANFTK, PRINTFTK, RETURNTK,
+    PLUS, MINU, MULT, DIV, LSS, LEQ, GRE, GEQ, EQL, NEQ, ASSIGN,
+    SEMICN, COMMA, LPARENT, RPARENT, LBRACK, RBRACK, LBRACE, RBRACE,
+    NONE // 不是单词（如空白），也用作"没有"
+};
+
+constexpr std::string_view TOKEN_NAMES[] = {
+    "IDENFR", "INTCON", "CHARCON", "STRCON",
+    "CONSTTK", "INTTK", "CHARTK", "VOIDTK", "MAINTK", "IFTK", "ELSETK", "DOTK", "WHILETK", "FORTK", "SCANFTK",
+    "PRINTFTK", "RETURNTK",
+    "PLUS", "MINU", "MULT", "DIV", "LSS", "LEQ", "GRE", "GEQ", "EQL", "NEQ", "ASSIGN",
+    "SEMICN", "COMMA", "LPARENT", "RPARENT", "LBRACK", "RBRACK", "LBRACE", "RBRACE",
+    "",
+};
+static_assert(sizeof(TOKEN_NAMES) / sizeof(TOKEN_NAMES[0]) == (size_t)TokenKind::NONE + 1, "类别码与名字表不一致");
+
+constexpr std::string_view tokenName(TokenKind kind) {
+    return TOKEN_NAMES[(size_t)kind];
+}
+
+// 一个单词：类别码和单词内容，内容直接指向源文件缓冲区
+struct Token {
+    TokenKind kind = TokenKind::NONE;
+    std::string_view text;
+};
+
+// ---------------- 保留字的完美哈希 ----------------
+
+namespace keywords {
+
+struct Keyword {
+    std::string_view text;
+    TokenKind kind;
+};
+
+constexpr Keyword LIST[] = {
+    {"const", TokenKind::CONSTTK}, {"int", TokenKind::INTTK}, {"char", TokenKind::CHARTK},
+    {"void", TokenKind::VOIDTK}, {"main", TokenKind::MAINTK}, {"if", TokenKind::IFTK},
+    {"else", TokenKind::ELSETK}, {"do", TokenKind::DOTK}, {"while", TokenKind::WHILETK},
+    {"for", TokenKind::FORTK}, {"scanf", TokenKind::SCANFTK}, {"printf", TokenKind::PRINTFTK},
+    {"return", TokenKind::RETURNTK},
+};
+constexpr size_t COUNT = sizeof(LIST) / sizeof(LIST[0]);
+constexpr size_t TABLE_SIZE = 16; // 2 的幂，不小于保留字个数
+
+// 哈希：h(s) = (长度 * a + 首字符 * b + 尾字符) & (TABLE_SIZE - 1)，参数 a, b 在编译期搜索
+struct HashParams {
+    uint32_t a = 0, b = 0;
+    bool found = false;
+};
+
+constexpr uint32_t hash(std::string_view s, HashParams p) {
+    return ((uint32_t)s.size() * p.a + (unsigned char)s[0] * p.b + (unsigned char)s[s.size() - 1]) &
+           (TABLE_SIZE - 1);
+}
+
+constexpr HashParams findParams() {
+    for (uint32_t a = 0; a < 64; a++) {
+        for (uint32_t b = 0; b < 64; b++) {
+            HashParams p{a, b, true};
+            bool used[TABLE_SIZE] = {};
+            bool ok = true;
+            for (size_t i = 0; i < COUNT && ok; i++) {
+                uint32_t h = hash(LIST[i].text, p);
+                ok = !used[h];
+                used[h] = true;
+            }
+            if (ok) return p;
+        }
+    }
+    return HashParams();
+}
+
+constexpr HashParams PARAMS = findParams();
+static_assert(PARAMS.found, "找不到保留字的完美哈希，需要调整 TABLE_SIZE 或哈希函数");
+
+// 哈希表：空位的 text 为空串，不会与任何标识符相等
+constexpr std::array<Keyword, TABLE_SIZE> buildTable() {
+    std::array<Keyword, TABLE_SIZE> table{};
+    for (auto& entry : table) entry = {std::string_view(), TokenKind::NONE};
+    for (size_t i = 0; i < COUNT; i++) table[hash(LIST[i].text, PARAMS)] = LIST[i];
+    return table;
+}
+
+constexpr std::array<Keyword, TABLE_SIZE> TABLE = buildTable();
+
+} // namespace keywords
+
+// 标识符 s（非空）是保留字时返回对应的类别码，否则返回 IDENFR
+constexpr TokenKind keywordKind(std::string_view s) {
+    const keywords::Keyword& entry = keywords::TABLE[keywords::hash(s, keywords::PARAMS)];
+    return entry.text == s ? entry.kind : TokenKind::IDENFR;
+}
+
+static_assert(keywordKind("return") == TokenKind::RETURNTK && keywordKind("main") == TokenKind::MAINTK &&
+              keywordKind("mains") == TokenKind::IDENFR && keywordKind("x") == TokenKind::IDENFR,
+              "保留字表错误");
+
+// ---------------- 单字符界符 ----------------
+
+constexpr std::array<TokenKind, 256> buildSingleCharKinds() {
+    std::array<TokenKind, 256> kinds{};
+    for (auto& k : kinds) k = TokenKind::NONE;
+    kinds['+'] = TokenKind::PLUS;
+    kinds['-'] = TokenKind::MINU;
+    kinds['*'] = TokenKind::MULT;
+    kinds['/'] = TokenKind::DIV;
+    kinds[';'] = TokenKind::SEMICN;
+    kinds[','] = TokenKind::COMMA;
+    kinds['('] = TokenKind::LPARENT;
+    kinds[')'] = TokenKind::RPARENT;
+    kinds['['] = TokenKind::LBRACK;
+    kinds[']'] = TokenKind::RBRACK;
+    kinds['{'] = TokenKind::LBRACE;
+    kinds['}'] = TokenKind::RBRACE;
+    return kinds;
+}
+
+// singleCharKind[c]：c 本身就是一个单词时为它的类别码，否则为 NONE
+constexpr std::array<TokenKind, 256> singleCharKind = buildSingleCharKinds();
+
+#endif
@@ -1,231 +1,107 @@
 #include <iostream>
-#include <map>
-#include <set>
-#include <stack>
-#include <vector>
 #include <string>
-#include <queue>
-#include <algorithm>
-#include <sstream>
+#include <cstdlib>
 
-using namespace std;
-
-// 结构体：存储边的信息
-struct Transition {
-    char val;      // 输入字符
-    string to;     // 目标状态ID (改为string以支持两位数状态)
-};
-
-// NFA存储：状态名 -> 边列表
-map<string, vector<Transition>> nfa;
-// 收集所有的输入符号 (a, b, c...)，不包含 '~'
-set<char> alphabet;
+#include "automata.h"
 
-// 字符串分割辅助函数
-vector<string> split(const string& str, const string& delimiter) {
-    vector<string> tokens;
-    size_t start = 0;
-    size_t end = str.find(delimiter);
+using namespace std;
 
-    while (end != string::npos) {
-        if (end > start) {
-            tokens.push_back(str.substr(start, end - start));
+// NFA → DFA。子集构造和惰性DFA在 automata 库中（determinize.cpp），这里只负责读入、解析参数和输出
+
+// 惰性DFA匹配模式：NFA之后的每个非空行是一个待匹配的串，输出 pass / error
+void runLazyMatch(const automata::AutomatonData& nfa, size_t budgetBytes, bool showStats) {
+    automata::LazyDFA lazy(nfa, budgetBytes);
+
+    string line, out;
+    size_t lines = 0;
+    while (getline(cin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        if (line.back() == '#') line.pop_back();
+        out += lazy.match(line.data(), line.size()) ? "pass\n" : "error\n";
+        lines++;
+        if (out.size() >= (1 << 16)) {
+            cout << out;
+            out.clear();
         }
-        start = end + delimiter.length();
-        end = str.find(delimiter, start);
-    }
-    if (start < str.length()) {
-        tokens.push_back(str.substr(start));
     }
-    return tokens;
-}
-
-// 获取单个状态的epsilon闭包 (包含自身)
-void getEpsilonClosureSingle(string state, set<string> &closure) {
-    // 避免死循环：如果已经处理过该状态，直接返回
-    if (closure.count(state)) return;
-
-    closure.insert(state);
+    cout << out;
 
-    if (nfa.count(state)) {
-        for (auto &edge : nfa[state]) {
-            if (edge.val == '~') {
-                getEpsilonClosureSingle(edge.to, closure);
-            }
-        }
+    if (showStats) {
+        automata::LazyDFAStats stats = lazy.stats();
+        cerr << "lines: " << lines << ", lazy DFA states built: " << stats.statesBuilt
+             << ", cached now: " << stats.cached << ", transition cache hits: " << stats.cacheHits
+             << ", flushes: " << stats.flushes << (stats.fellBackToNFA ? ", fell back to NFA simulation" : "") << endl;
     }
 }
 
-// 获取一个集合的epsilon闭包
-set<string> getSetEpsilonClosure(const set<string>& states) {
-    set<string> result;
-    for (const auto& s : states) {
-        getEpsilonClosureSingle(s, result); // 此时 result 充当 visited 集合
+int main(int argc, char* argv[]) {
+    // --stats：在标准错误输出 move 缓存的命中/未命中次数
+    // --lazy：不做完全确定化，用惰性DFA匹配NFA之后输入的每一行
+    //   --cache-kb <大小>：惰性DFA状态缓存的内存上限，默认 16384 KB
+    // --parallel：多线程子集构造，输出与串行版本相同
+    //   -j <线程数>：线程数，默认使用全部核心
+    // --read-bin <文件>：从二进制自动机文件读入NFA，不再从标准输入读文本
+    // --write-bin <文件>：把DFA写成二进制自动机文件，不再输出文本
+    const char* readBinPath = nullptr;
+    const char* writeBinPath = nullptr;
+    bool showStats = false;
+    bool lazyMode = false;
+    automata::DeterminizeOptions options;
+    size_t cacheBudget = (size_t)16 << 20;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--stats") showStats = true;
+        else if (arg == "--lazy") lazyMode = true;
+        else if (arg == "--cache-kb" && i + 1 < argc) cacheBudget = (size_t)atol(argv[++i]) << 10;
+        else if (arg == "--parallel") options.parallel = true;
+        else if (arg == "-j" && i + 1 < argc) options.threads = (unsigned)atoi(argv[++i]);
+        else if (arg == "--read-bin" && i + 1 < argc) readBinPath = argv[++i];
+        else if (arg == "--write-bin" && i + 1 < argc) writeBinPath = argv[++i];
     }
-    return result;
-}
 
-// Move操作：从状态集合states经过字符val能到达的NFA状态集合
-set<string> moveSet(const set<string>& states, char val) {
-    set<string> result;
-    for (const auto& s : states) {
-        if (nfa.count(s)) {
-            for (auto &edge : nfa[s]) {
-                if (edge.val == val) {
-                    result.insert(edge.to);
-                }
-            }
+    // 1. 读入NFA：文本中名字含 'Y' 的状态为终态，初态为 X
+    automata::AutomatonData nfa;
+    if (readBinPath) {
+        automata::MappedAutomaton file;
+        string error;
+        if (!file.open(readBinPath, error)) {
+            cerr << error << endl;
+            return 1;
         }
+        nfa = automata::toAutomatonData(file.view());
+    } else {
+        nfa = automata::parseAutomatonText(cin);
     }
-    return result;
-}
-
-// 检查集合中是否包含NFA的终态 (这里假设NFA中包含'Y'的即为终态)
-bool isFinalSet(const set<string>& states) {
-    for (const auto& s : states) {
-        // 如果状态名包含 'Y'，认为是终态
-        if (s.find('Y') != string::npos) return true;
+    if (nfa.findState("X") < 0 && (!readBinPath || nfa.stateCount() == 0)) {
+        // 输入中没有出现 X 时补上一个没有出边的初态
+        nfa.startState = nfa.addState("X", false);
     }
-    return false;
-}
-
-// 定义DFA的边
-struct DfaEdge {
-    string from;
-    char input;
-    string to;
-};
-
-int main() {
-    string line;
-    while (getline(cin, line) && !line.empty()) {
-        vector<string> parts = split(line, " ");
-        if (parts.empty()) continue;
 
-        string u = parts[0];
-        // 确保该状态在NFA中有记录（即使没有出边）
-        if (nfa.find(u) == nfa.end()) {
-            nfa[u] = {};
-        }
-
-        for (size_t i = 1; i < parts.size(); i++) {
-            string transStr = parts[i];
-            // 解析格式: u-a->v
-            // 找到第一个 '-' 和 "->" 的位置
-            size_t firstDash = transStr.find('-');
-            size_t arrow = transStr.find("->");
-
-            if (firstDash != string::npos && arrow != string::npos) {
-                // 提取转换字符 (可能在 - 和 -> 之间)
-                // 假设转换字符只有一个字符
-                char val = transStr[firstDash + 1];
-                string v = transStr.substr(arrow + 2);
-
-                nfa[u].push_back({val, v});
-                if (val != '~') {
-                    alphabet.insert(val);
-                }
-            }
-        }
+    if (lazyMode) {
+        runLazyMatch(nfa, cacheBudget, showStats);
+        return 0;
     }
 
-    // 2. 子集构造法构建DFA
+    // 2. 子集构造法构建DFA，结果已按 X、Y...、数字 排好序
+    automata::DeterminizeStats stats;
+    automata::AutomatonData dfa = automata::determinize(nfa, options, &stats);
 
-    // 状态映射：NFA状态集合 -> DFA状态名
-    map<set<string>, string> subsetToDfaName;
-    // 队列：待处理的DFA状态(即NFA子集)
-    queue<set<string>> processingQueue;
-    // 存储DFA的转换边
-    vector<DfaEdge> dfaEdges;
-
-    int processIdCnt = 0; // 0, 1, 2...
-    int finalIdCnt = 0;   // Y, Y1, Y2...
-
-    // 初始状态 X 的闭包
-    set<string> startSet = getSetEpsilonClosure({"X"});
-    subsetToDfaName[startSet] = "X";
-    processingQueue.push(startSet);
-
-    // 记录已经生成的DFA状态名，用于后续排序输出
-    vector<string> dfaStatesList;
-    dfaStatesList.push_back("X");
-
-    while (!processingQueue.empty()) {
-        set<string> currentSet = processingQueue.front();
-        processingQueue.pop();
-
-        string currentDfaName = subsetToDfaName[currentSet];
-
-        // 对字母表中的每个符号进行转移
-        for (char inputChar : alphabet) {
-            // move(T, a)
-            set<string> temp = moveSet(currentSet, inputChar);
-            // epsilon-closure(move(T, a))
-            set<string> nextSet = getSetEpsilonClosure(temp);
-
-            if (nextSet.empty()) continue;
-
-
-            if (subsetToDfaName.find(nextSet) == subsetToDfaName.end()) {
-                string newName;
-                // 命名逻辑
-                if (isFinalSet(nextSet)) {
-                    if (finalIdCnt == 0) newName = "Y";
-                    else newName = "Y" + to_string(finalIdCnt);
-                    finalIdCnt++;
-                } else {
-                    newName = to_string(processIdCnt++);
-                }
-
-                subsetToDfaName[nextSet] = newName;
-                dfaStatesList.push_back(newName);
-                processingQueue.push(nextSet);
-            }
-
-            // 记录边
-            dfaEdges.push_back({currentDfaName, inputChar, subsetToDfaName[nextSet]});
+    // 3. 输出，题目要求输出形式归组： X X-a->0 X-b->1
+    if (writeBinPath) {
+        if (!automata::writeAutomaton(writeBinPath, dfa)) {
+            cerr << "无法写入文件 " << writeBinPath << endl;
+            return 1;
         }
+    } else {
+        cout << automata::formatAutomatonText(dfa);
     }
 
-    // 3. 输出格式化
-    // 题目要求输出形式归组： X X-a->0 X-b->1
-
-
-    vector<string> sortedStates = dfaStatesList;
-    sort(sortedStates.begin(), sortedStates.end(), [](const string& a, const string& b) {
-        // 自定义优先级: X最前, Y其次, 数字最后
-        int prioA = (a == "X") ? 0 : (a[0] == 'Y' ? 1 : 2);
-        int prioB = (b == "X") ? 0 : (b[0] == 'Y' ? 1 : 2);
-        if (prioA != prioB) return prioA < prioB;
-        // 同类比较
-        if (a[0] == 'Y' && b[0] == 'Y') {
-            if (a == "Y") return true;
-            if (b == "Y") return false;
-            return a.length() < b.length() || (a.length() == b.length() && a < b);
-        }
-        if (isdigit(a[0]) && isdigit(b[0])) {
-             return stoi(a) < stoi(b);
-        }
-        return a < b;
-    });
-
-    for (const string& u : sortedStates) {
-        cout << u;
-        // 找所有从 u 出发的边
-        vector<pair<char, string>> edges;
-        for (const auto& edge : dfaEdges) {
-            if (edge.from == u) {
-                edges.push_back({edge.input, edge.to});
-            }
-        }
-        // 按字符排序 a, b...
-        sort(edges.begin(), edges.end());
-
-        for (const auto& e : edges) {
-            cout << " " << u << "-" << e.first << "->" << e.second;
-        }
-        cout << endl;
+    if (showStats) {
+        cerr << "DFA states: " << dfa.stateCount()
+             << ", move cache hits: " << stats.moveCacheHits
+             << ", misses: " << stats.moveCacheMisses << endl;
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+# 比较 Thompson 与 Glushkov 两种构造得到的 NFA 交给 NFA-DFA 确定化的端到端耗时，
+# 以及 --dfa 由 followpos 直接构造DFA的耗时
+# 用法：bench.sh <NFA 可执行文件> <NFA-DFA 可执行文件>
+set -e
+
+NFA_BIN=${1:?"用法: $0 <NFA> <NFA-DFA>"}
+DFA_BIN=${2:?"用法: $0 <NFA> <NFA-DFA>"}
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+now_ms() { echo $(( $(date +%s%N) / 1000000 )); }
+
+# 计时：NFA 构造 + NFA-DFA 确定化，输出 毫秒 和 NFA 行数
+run() {
+    local regex=$1 mode=$2
+    local t0 t1 t2
+    t0=$(now_ms)
+    echo "$regex" | "$NFA_BIN" $mode > "$TMP/nfa.txt"
+    t1=$(now_ms)
+    "$DFA_BIN" < "$TMP/nfa.txt" > "$TMP/dfa.txt"
+    t2=$(now_ms)
+    printf '%8d %8d %10d' $((t1 - t0)) $((t2 - t1)) "$(wc -l < "$TMP/nfa.txt")"
+}
+
+# 计时：--dfa 直接输出DFA，没有NFA
+run_direct() {
+    local t0 t1
+    t0=$(now_ms)
+    echo "$1" | "$NFA_BIN" --dfa > "$TMP/dfa.txt"
+    t1=$(now_ms)
+    printf '%8s %8d %10s' - $((t1 - t0)) -
+}
+
+# (a|b)*a(a|b)^k：DFA 状态数为 2^(k+1)
+suffix_regex() {
+    local r='(a|b)*a' i
+    for ((i = 0; i < $1; ++i)); do r+='(a|b)'; done
+    echo "$r"
+}
+
+# ((ab|ba)*c|d)^n：较长的正规式，闭包和并集较多
+long_regex() {
+    local r='' i
+    for ((i = 0; i < $1; ++i)); do r+='((ab|ba)*c|d)'; done
+    echo "$r"
+}
+
+printf '%-28s %-9s %8s %8s %10s\n' "regex" "mode" "NFA(ms)" "DFA(ms)" "NFA states"
+for k in 8 10 12 14; do
+    regex=$(suffix_regex $k)
+    printf '%-28s %-9s %s\n' "(a|b)*a(a|b)^$k" thompson "$(run "$regex" '')"
+    printf '%-28s %-9s %s\n' "(a|b)*a(a|b)^$k" glushkov "$(run "$regex" --glushkov)"
+    printf '%-28s %-9s %s\n' "(a|b)*a(a|b)^$k" direct "$(run_direct "$regex")"
+done
+for n in 500 2000 8000; do
+    regex=$(long_regex $n)
+    printf '%-28s %-9s %s\n' "((ab|ba)*c|d)^$n" thompson "$(run "$regex" '')"
+    printf '%-28s %-9s %s\n' "((ab|ba)*c|d)^$n" glushkov "$(run "$regex" --glushkov)"
+    printf '%-28s %-9s %s\n' "((ab|ba)*c|d)^$n" direct "$(run_direct "$regex")"
+done
@@ -0,0 +1,105 @@
+#include "ast.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ast {
+
+const char* kindName(NodeKind kind) {
+    static const char* const NAMES[] = {
+        "Program", "ConstDecl", "ConstDef", "VarDecl", "VarDef", "Function", "Param", "Compound",
+        "Block", "If", "While", "DoWhile", "For", "Assign", "Call", "Read", "Write", "Return", "Empty",
+        "Condition", "Unary", "Binary", "Ident", "Index", "IntLit", "CharLit", "StrLit",
+    };
+    return NAMES[(size_t)kind];
+}
+
+void writeTree(const Ast& tree, OutputBuffer& out) {
+    // 先序遍历，显式栈保存 (结点, 深度)，树再深也不会栈溢出
+    std::vector<std::pair<NodeId, uint32_t>> stack;
+    if (tree.root != NIL) stack.push_back({tree.root, 0});
+    std::vector<NodeId> children;
+    std::string line;
+    while (!stack.empty()) {
+        auto [id, depth] = stack.back();
+        stack.pop_back();
+        const Node& node = tree.nodes[id];
+
+        line.assign(depth * 2, ' ');
+        line += kindName(node.kind);
+        if (node.op != TokenKind::NONE) {
+            line += ' ';
+            line += tokenName(node.op);
+        }
+        switch (node.kind) {
+            case NodeKind::ConstDef:
+            case NodeKind::VarDef:
+            case NodeKind::Function:
+            case NodeKind::Param:
+            case NodeKind::Call:
+            case NodeKind::Ident:
+            case NodeKind::Index:
+                line += ' ';
+                line += tree.symbols.name(node.symbol);
+                break;
+            case NodeKind::IntLit:
+                line += ' ';
+                line += std::to_string(node.value);
+                break;
+            case NodeKind::CharLit:
+                line += " '";
+                line += (char)node.value;
+                line += '\'';
+                break;
+            case NodeKind::StrLit:
+                line += " \"";
+                line += tree.strings.name(node.string);
+                line += '"';
+                break;
+            default:
+                break;
+        }
+        line += '\n';
+        out.write(line);
+
+        // 子结点逆序入栈，按原顺序输出
+        children.clear();
+        for (NodeId c = node.firstChild; c != NIL; c = tree.nodes[c].nextSibling) children.push_back(c);
+        for (size_t i = children.size(); i-- > 0;) stack.push_back({children[i], depth + 1});
+    }
+}
+
+NodeId appendNodes(Ast& dst, const Ast& src) {
+    NodeId base = (NodeId)dst.nodes.size();
+    // 按 src 中编号的顺序驻留，合并顺序与源程序顺序一致时编号与整体分析相同
+    std::vector<uint32_t> symbols(src.symbols.size()), strings(src.strings.size());
+    for (uint32_t i = 0; i < symbols.size(); i++) symbols[i] = dst.symbols.intern(src.symbols.name(i));
+    for (uint32_t i = 0; i < strings.size(); i++) strings[i] = dst.strings.intern(src.strings.name(i));
+
+    for (NodeId id = 0; id < src.nodes.size(); id++) {
+        Node node = src.nodes[id];
+        if (node.firstChild != NIL) node.firstChild += base;
+        if (node.nextSibling != NIL) node.nextSibling += base;
+        switch (node.kind) {
+            case NodeKind::ConstDef:
+            case NodeKind::VarDef:
+            case NodeKind::Function:
+            case NodeKind::Param:
+            case NodeKind::Call:
+            case NodeKind::Ident:
+            case NodeKind::Index:
+                node.symbol = symbols[node.symbol];
+                break;
+            case NodeKind::StrLit:
+                node.string = strings[node.string];
+                break;
+            default:
+                break;
+        }
+        dst.nodes.push(node);
+    }
+    return base;
+}
+
+} // namespace ast
@@ -0,0 +1,147 @@
+#ifndef SYNTACTIC_AST_H
+#define SYNTACTIC_AST_H
+
+// 语法树。结点放在按块分配的结点区（arena）中，只追加不单独释放，整棵树由 clear() 一次释放；
+// 结点之间用 32 位下标连接（第一个子结点、下一个兄弟结点），结点 16 字节，
+// 载荷是按结点种类解释的联合体；标识符驻留为整数编号，字符串常量驻留在另一张表中。
+//
+// 各种结点的子结点（按顺序）和载荷：
+//   Program      [ConstDecl] [VarDecl] Function...（最后一个是 main）
+//   ConstDecl    ConstDef...
+//   ConstDef     op = 类型，symbol = 名字；子结点为 IntLit 或 CharLit
+//   VarDecl      VarDef...
+//   VarDef       op = 类型，symbol = 名字；数组有一个子结点 IntLit（元素个数）
+//   Function     op = 返回类型（INTTK / CHARTK / VOIDTK），symbol = 名字；Param... Compound
+//   Param        op = 类型，symbol = 名字
+//   Compound     [ConstDecl] [VarDecl] 语句...
+//   Block        语句...（'{' 语句列 '}'）
+//   If           Condition 语句 [语句]
+//   While        Condition 语句
+//   DoWhile      语句 Condition
+//   For          Assign Condition Assign 语句（第二个 Assign 为 标识符 = 标识符 ± 步长）
+//   Assign       Ident / Index 表达式
+//   Call         op = INTTK（有返回值）或 VOIDTK，symbol = 函数名；实参表达式...
+//   Read         Ident...
+//   Write        [StrLit] [表达式]
+//   Return       [表达式]
+//   Empty        空语句
+//   Condition    op = 关系运算符，没有时为 NONE；表达式 [表达式]
+//   Unary        op = PLUS / MINU；表达式（只出现在表达式的第一项前）
+//   Binary       op = PLUS / MINU / MULT / DIV；左 右
+//   Ident        symbol
+//   Index        symbol；下标表达式
+//   IntLit       value（带符号的整数已合并符号）
+//   CharLit      value = 字符
+//   StrLit       string = 字符串表中的编号
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "interner.h"
+#include "source_io.h"
+#include "token.h"
+
+namespace ast {
+
+using NodeId = uint32_t;
+const NodeId NIL = 0xFFFFFFFF;
+
+enum class NodeKind : uint8_t {
+    Program, ConstDecl, ConstDef, VarDecl, VarDef, Function, Param, Compound,
+    Block, If, While, DoWhile, For, Assign, Call, Read, Write, Return, Empty,
+    Condition, Unary, Binary, Ident, Index, IntLit, CharLit, StrLit,
+};
+
+struct Node {
+    NodeKind kind = NodeKind::Empty;
+    TokenKind op = TokenKind::NONE; // 运算符或类型
+    NodeId firstChild = NIL;
+    NodeId nextSibling = NIL;
+    union {
+        int32_t value;   // IntLit、CharLit
+        uint32_t symbol; // 标识符的编号
+        uint32_t string; // StrLit 在字符串表中的编号
+    };
+
+    Node() : value(0) {}
+};
+static_assert(sizeof(Node) == 16, "结点应为 16 字节");
+
+// 结点区：第 b 块有 FIRST_BLOCK << b 个结点，块满了才分配下一块，已有的结点不搬动；
+// 下标到块内位置只需一次求最高位
+class NodeArena {
+public:
+    NodeArena() {}
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    NodeId push(const Node& node) {
+        if (size_ == capacity_) grow();
+        NodeId id = (NodeId)size_++;
+        (*this)[id] = node;
+        return id;
+    }
+
+    Node& operator[](NodeId id) {
+        uint64_t j = (uint64_t)id + FIRST_BLOCK;
+        unsigned b = 63 - __builtin_clzll(j) - FIRST_BLOCK_BITS;
+        return blocks_[b][j - ((uint64_t)FIRST_BLOCK << b)];
+    }
+    const Node& operator[](NodeId id) const { return const_cast<NodeArena&>(*this)[id]; }
+
+    size_t size() const { return size_; }
+    size_t blockCount() const { return blockCount_; }
+    size_t bytes() const { return capacity_ * sizeof(Node); }
+
+    // 一次释放所有结点
+    void clear() {
+        for (size_t b = 0; b < blockCount_; b++) blocks_[b].reset();
+        blockCount_ = 0;
+        size_ = capacity_ = 0;
+    }
+
+private:
+    static const unsigned FIRST_BLOCK_BITS = 12;
+    static const uint64_t FIRST_BLOCK = 1ull << FIRST_BLOCK_BITS;
+    static const size_t MAX_BLOCKS = 33 - FIRST_BLOCK_BITS;
+
+    void grow() {
+        size_t n = (size_t)FIRST_BLOCK << blockCount_;
+        blocks_[blockCount_++].reset(new Node[n]);
+        capacity_ += n;
+    }
+
+    std::unique_ptr<Node[]> blocks_[MAX_BLOCKS];
+    size_t blockCount_ = 0;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+// 一棵语法树：结点、标识符表和字符串表
+struct Ast {
+    NodeArena nodes;
+    Interner symbols;
+    Interner strings;
+    NodeId root = NIL;
+
+    void clear() {
+        nodes.clear();
+        symbols.clear();
+        strings.clear();
+        root = NIL;
+    }
+};
+
+const char* kindName(NodeKind kind);
+
+// 把树按先序、每个结点一行（缩进表示深度）写出，用于检查
+void writeTree(const Ast& tree, OutputBuffer& out);
+
+// 把 src 的全部结点按原顺序追加到 dst 的结点区，标识符和字符串重新驻留到 dst 的表中；
+// 返回 src 的 0 号结点在 dst 中的下标（src 中的下标都加上它）。并行分析时用于合并各线程分别建立的部分
+NodeId appendNodes(Ast& dst, const Ast& src);
+
+} // namespace ast
+
+#endif
@@ -0,0 +1,80 @@
+#include "interner.h"
+
+#include <cstring>
+
+uint32_t Interner::intern(std::string_view s) {
+    uint32_t h = hash(s);
+    if (!slots_.empty()) {
+        size_t slot = slotOf(s, h);
+        if (slots_[slot] != 0) return slots_[slot] - 1;
+    }
+    // 装载因子不超过 1/2
+    if ((names_.size() + 1) * 2 > slots_.size()) rehash();
+    uint32_t id = (uint32_t)names_.size();
+    names_.push_back(std::string_view(store(s), s.size()));
+    hashes_.push_back(h);
+    slots_[slotOf(s, h)] = id + 1;
+    return id;
+}
+
+uint32_t Interner::find(std::string_view s) const {
+    if (slots_.empty()) return NONE;
+    size_t slot = slotOf(s, hash(s));
+    return slots_[slot] == 0 ? NONE : slots_[slot] - 1;
+}
+
+size_t Interner::slotOf(std::string_view s, uint32_t h) const {
+    size_t mask = slots_.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+        uint32_t entry = slots_[i];
+        if (entry == 0) return i;
+        if (hashes_[entry - 1] == h && names_[entry - 1] == s) return i;
+    }
+}
+
+const char* Interner::store(std::string_view s) {
+    if (s.size() > BLOCK_SIZE / 4) {
+        // 很长的字符串单独分配，不浪费当前块的剩余空间
+        blocks_.push_back(std::make_unique<char[]>(s.size()));
+        poolBytes_ += s.size();
+        memcpy(blocks_.back().get(), s.data(), s.size());
+        return blocks_.back().get();
+    }
+    if (s.size() > blockLeft_) {
+        blocks_.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+        poolBytes_ += BLOCK_SIZE;
+        blockNext_ = blocks_.back().get();
+        blockLeft_ = BLOCK_SIZE;
+    }
+    char* p = blockNext_;
+    memcpy(p, s.data(), s.size());
+    blockNext_ += s.size();
+    blockLeft_ -= s.size();
+    return p;
+}
+
+void Interner::rehash() {
+    size_t capacity = slots_.empty() ? 64 : slots_.size() * 2;
+    slots_.assign(capacity, 0);
+    size_t mask = capacity - 1;
+    for (uint32_t id = 0; id < names_.size(); id++) {
+        size_t i = hashes_[id] & mask;
+        while (slots_[i] != 0) i = (i + 1) & mask;
+        slots_[i] = id + 1;
+    }
+}
+
+size_t Interner::bytes() const {
+    return poolBytes_ + names_.capacity() * sizeof(std::string_view) + hashes_.capacity() * sizeof(uint32_t) +
+           slots_.capacity() * sizeof(uint32_t);
+}
+
+void Interner::clear() {
+    names_.clear();
+    hashes_.clear();
+    slots_.clear();
+    blocks_.clear();
+    blockNext_ = nullptr;
+    blockLeft_ = 0;
+    poolBytes_ = 0;
+}
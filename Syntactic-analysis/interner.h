@@ -0,0 +1,54 @@
+#ifndef SYNTACTIC_INTERNER_H
+#define SYNTACTIC_INTERNER_H
+
+// 字符串驻留：相同的字符串只保存一份，用从 0 开始的整数编号代表。
+// 字符保存在按块分配的字符串池中（块满了才分配新块，不搬动已有的字符），name() 返回的 string_view 一直有效；
+// 查找用开放定址的哈希表，表中只存编号，比较前先比较保存的哈希值。
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class Interner {
+public:
+    static const uint32_t NONE = 0xFFFFFFFF;
+
+    // s 的编号，第一次出现时分配新编号
+    uint32_t intern(std::string_view s);
+    // s 的编号，没有出现过时返回 NONE（不修改表）
+    uint32_t find(std::string_view s) const;
+
+    std::string_view name(uint32_t id) const { return names_[id]; }
+    size_t size() const { return names_.size(); }
+    // 字符串池和哈希表占用的字节数
+    size_t bytes() const;
+
+    void clear();
+
+private:
+    static const size_t BLOCK_SIZE = 1 << 16;
+
+    static uint32_t hash(std::string_view s) {
+        // FNV-1a
+        uint32_t h = 2166136261u;
+        for (unsigned char c : s) h = (h ^ c) * 16777619u;
+        return h;
+    }
+
+    // 找 s 所在的槽；不存在时返回应插入的空槽
+    size_t slotOf(std::string_view s, uint32_t h) const;
+    const char* store(std::string_view s);
+    void rehash();
+
+    std::vector<std::string_view> names_;
+    std::vector<uint32_t> hashes_;
+    std::vector<uint32_t> slots_; // 编号 + 1，0 为空槽
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* blockNext_ = nullptr; // 当前块中下一个空闲字节
+    size_t blockLeft_ = 0;
+    size_t poolBytes_ = 0;
+};
+
+#endif
@@ -0,0 +1,323 @@
+#include "ll1.h"
+
+#include <cctype>
+#include <unordered_map>
+
+namespace {
+
+const char* const ACTION_NAMES[ACTION_COUNT] = {"@define", "@void", "@var", "@scope", "@endscope", "@callee", "@call"};
+
+bool isTerminal(uint16_t s) { return s < LL1_TERMINALS; }
+bool isNonterminal(uint16_t s) { return s >= LL1_NONTERMINAL && s < LL1_END; }
+
+// 类别码的名字对应的终结符，不是类别码时返回 -1
+int terminalOf(std::string_view name) {
+    for (uint16_t t = 0; t < (uint16_t)TokenKind::NONE; t++) {
+        if (tokenName((TokenKind)t) == name) return t;
+    }
+    return -1;
+}
+
+// 以空白分隔的词
+std::vector<std::string_view> splitWords(std::string_view s) {
+    std::vector<std::string_view> words;
+    size_t i = 0;
+    while (i < s.size()) {
+        while (i < s.size() && isspace((unsigned char)s[i])) i++;
+        size_t begin = i;
+        while (i < s.size() && !isspace((unsigned char)s[i])) i++;
+        if (i > begin) words.push_back(s.substr(begin, i - begin));
+    }
+    return words;
+}
+
+// symbols[from..] 的 FIRST 集，nullable 表示整段可以为空
+uint64_t firstOf(const LL1Grammar& g, const std::vector<uint16_t>& symbols, size_t from, bool& nullable) {
+    uint64_t first = 0;
+    for (size_t i = from; i < symbols.size(); i++) {
+        uint16_t s = symbols[i];
+        if (isTerminal(s)) {
+            nullable = false;
+            return first | (1ull << s);
+        }
+        if (isNonterminal(s)) {
+            const LL1Nonterminal& nt = g.nonterminals[s - LL1_NONTERMINAL];
+            first |= nt.first;
+            if (!nt.nullable) {
+                nullable = false;
+                return first;
+            }
+        }
+        // 语义动作不读入单词
+    }
+    nullable = true;
+    return first;
+}
+
+} // namespace
+
+bool buildLL1Grammar(std::string_view description, LL1Grammar& g, std::string& error) {
+    g = LL1Grammar();
+    std::vector<std::string_view> words = splitWords(description);
+
+    // 1. 先收集所有左部，非终结符可以先使用后定义
+    std::unordered_map<std::string_view, uint16_t> index;
+    for (size_t i = 0; i + 1 < words.size(); i++) {
+        bool ruleStart = i == 0 || words[i - 1] == ";";
+        if (!ruleStart) continue;
+        if (index.count(words[i])) {
+            error = "非终结符 " + std::string(words[i]) + " 重复定义";
+            return false;
+        }
+        index[words[i]] = (uint16_t)g.nonterminals.size();
+        g.nonterminals.emplace_back();
+        g.nonterminals.back().name = std::string(words[i]);
+    }
+    if (g.nonterminals.empty()) {
+        error = "文法为空";
+        return false;
+    }
+
+    // 2. 解析每条规则的候选
+    size_t i = 0;
+    for (LL1Nonterminal& nt : g.nonterminals) {
+        i++; // 左部
+        if (i < words.size() && words[i].size() > 1 && words[i][0] == '<') nt.marker = std::string(words[i++]);
+        if (i >= words.size() || words[i] != "::=") {
+            error = nt.name + " 后应为 ::=";
+            return false;
+        }
+        i++;
+        nt.alternatives.emplace_back();
+        for (;; i++) {
+            if (i >= words.size()) {
+                error = nt.name + " 的规则缺少结尾的 ;";
+                return false;
+            }
+            std::string_view w = words[i];
+            LL1Alternative& alt = nt.alternatives.back();
+            if (w == ";") {
+                i++;
+                break;
+            }
+            if (w == "|") {
+                nt.alternatives.emplace_back();
+            } else if (w == "ε") {
+                // 空候选
+            } else if (w[0] == '?') {
+                // ?k=类别码 / ?k!=类别码
+                size_t eq = w.find('=');
+                bool equal = eq != std::string_view::npos && w[eq - 1] != '!';
+                int kind = eq == std::string_view::npos ? -1 : terminalOf(w.substr(eq + 1));
+                int offset = w.size() > 1 ? w[1] - '0' : 0;
+                if (kind < 0 || offset < 1 || offset >= (int)TokenStream::LOOKAHEAD || !alt.symbols.empty()) {
+                    error = nt.name + " 的预读条件 " + std::string(w) + " 有误";
+                    return false;
+                }
+                alt.guard = LL1Guard{(uint8_t)offset, equal, (TokenKind)kind};
+            } else if (w[0] == '@') {
+                uint16_t action = ACTION_COUNT;
+                for (uint16_t a = 0; a < ACTION_COUNT; a++) {
+                    if (w == ACTION_NAMES[a]) action = a;
+                }
+                if (action == ACTION_COUNT) {
+                    error = "未知的语义动作 " + std::string(w);
+                    return false;
+                }
+                alt.symbols.push_back((uint16_t)(LL1_ACTION + action));
+            } else if (int t = terminalOf(w); t >= 0) {
+                alt.symbols.push_back((uint16_t)t);
+            } else if (auto it = index.find(w); it != index.end()) {
+                alt.symbols.push_back((uint16_t)(LL1_NONTERMINAL + it->second));
+            } else {
+                error = nt.name + " 中的符号 " + std::string(w) + " 未定义";
+                return false;
+            }
+        }
+    }
+
+    // 3. FIRST 集和可空性：迭代到不再变化
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (LL1Nonterminal& nt : g.nonterminals) {
+            for (const LL1Alternative& alt : nt.alternatives) {
+                bool nullable;
+                uint64_t first = firstOf(g, alt.symbols, 0, nullable);
+                if ((nt.first | first) != nt.first || (nullable && !nt.nullable)) {
+                    nt.first |= first;
+                    nt.nullable = nt.nullable || nullable;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // 4. FOLLOW 集：开始符号后是输入结束
+    g.nonterminals[0].follow = 1ull << (uint16_t)TokenKind::NONE;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (LL1Nonterminal& nt : g.nonterminals) {
+            for (const LL1Alternative& alt : nt.alternatives) {
+                for (size_t j = 0; j < alt.symbols.size(); j++) {
+                    if (!isNonterminal(alt.symbols[j])) continue;
+                    LL1Nonterminal& b = g.nonterminals[alt.symbols[j] - LL1_NONTERMINAL];
+                    bool nullable;
+                    uint64_t follow = firstOf(g, alt.symbols, j + 1, nullable);
+                    if (nullable) follow |= nt.follow;
+                    if ((b.follow | follow) != b.follow) {
+                        b.follow |= follow;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // 5. 预测分析表：候选 α 在 FIRST(α) 中的单词下可用，α 可空时在 FOLLOW(A) 中的单词下也可用
+    std::vector<std::vector<uint16_t>> cells(g.nonterminals.size() * LL1_TERMINALS);
+    for (size_t a = 0; a < g.nonterminals.size(); a++) {
+        LL1Nonterminal& nt = g.nonterminals[a];
+        for (size_t k = 0; k < nt.alternatives.size(); k++) {
+            LL1Alternative& alt = nt.alternatives[k];
+            bool nullable;
+            uint64_t predict = firstOf(g, alt.symbols, 0, nullable);
+            if (nullable) predict |= nt.follow;
+            if (nullable && nt.emptyAlternative < 0) nt.emptyAlternative = (int32_t)k;
+            for (uint16_t t = 0; t < LL1_TERMINALS; t++) {
+                if (predict & (1ull << t)) cells[a * LL1_TERMINALS + t].push_back((uint16_t)k);
+            }
+            alt.pushBegin = (uint32_t)g.pushes.size();
+            if (!nt.marker.empty()) g.pushes.push_back((uint16_t)(LL1_END + a));
+            g.pushes.insert(g.pushes.end(), alt.symbols.rbegin(), alt.symbols.rend());
+            alt.pushLength = (uint32_t)g.pushes.size() - alt.pushBegin;
+        }
+    }
+    g.table.assign(cells.size(), LL1Grammar::NO_ENTRY);
+    for (size_t c = 0; c < cells.size(); c++) {
+        const std::vector<uint16_t>& cell = cells[c];
+        if (cell.empty()) continue;
+        const LL1Nonterminal& nt = g.nonterminals[c / LL1_TERMINALS];
+        if (cell.size() == 1 && nt.alternatives[cell[0]].guard.offset == 0) {
+            g.table[c] = cell[0];
+        } else {
+            g.table[c] = LL1Grammar::CONFLICT + (int32_t)g.conflicts.size();
+            g.conflicts.push_back(cell);
+        }
+    }
+    return true;
+}
+
+bool LL1Parser::guardHolds(const LL1Guard& guard) {
+    if (guard.offset == 0) return true;
+    return ts_.at(guard.kind, guard.offset) == guard.equal;
+}
+
+void LL1Parser::fail(std::string_view what) {
+    if (!error_.empty()) return;
+    const Token& tok = ts_.peek();
+    error_ = "语法错误：应为 " + std::string(what) + "，实际为 ";
+    error_ += tok.kind == TokenKind::NONE ? std::string("文件结尾")
+                                          : std::string(tokenName(tok.kind)) + " " + std::string(tok.text);
+}
+
+// 在当前作用域中定义最近接受的标识符；重复定义时保留原来的定义（与递归子程序法相同）
+void LL1Parser::define(Symbol symbol) {
+    if (lastSymbol_ != Interner::NONE) symbols_.define(lastSymbol_, symbol);
+}
+
+// 非终结符在当前单词下没有候选：有成分名时报告成分名（与递归子程序法相同），否则列出它 FIRST 集中的单词
+void LL1Parser::failExpecting(const LL1Nonterminal& nt) {
+    if (nt.marker.size() > 2) {
+        fail(std::string_view(nt.marker).substr(1, nt.marker.size() - 2));
+        return;
+    }
+    std::string expected;
+    for (uint16_t t = 0; t < (uint16_t)TokenKind::NONE; t++) {
+        if (!(nt.first & (1ull << t))) continue;
+        if (!expected.empty()) expected += " 或 ";
+        expected += tokenName((TokenKind)t);
+    }
+    fail(expected);
+}
+
+bool LL1Parser::parse() {
+    stack_.clear();
+    stack_.push_back(LL1_NONTERMINAL);
+    while (!stack_.empty()) {
+        uint16_t s = stack_.back();
+        stack_.pop_back();
+
+        if (isTerminal(s)) {
+            // 终结符：与当前单词匹配则接受，否则记录错误（不接受，与递归子程序法的处理相同）
+            const Token& tok = ts_.peek();
+            if (tok.kind != (TokenKind)s) {
+                fail(tokenName((TokenKind)s));
+                continue;
+            }
+            if (tok.kind == TokenKind::IDENFR) lastSymbol_ = ts_.symbol();
+            ts_.consume();
+        } else if (s >= LL1_ACTION) {
+            switch (s - LL1_ACTION) {
+                case ACTION_DEFINE_VALUE_FUNCTION:
+                    define(Symbol{SymbolKind::Function, TokenKind::INTTK});
+                    break;
+                case ACTION_DEFINE_VOID_FUNCTION:
+                    define(Symbol{SymbolKind::Function, TokenKind::VOIDTK});
+                    break;
+                case ACTION_DEFINE_OBJECT:
+                    define(Symbol{SymbolKind::Var});
+                    break;
+                case ACTION_SCOPE_BEGIN:
+                    symbols_.pushScope();
+                    break;
+                case ACTION_SCOPE_END:
+                    symbols_.popScope();
+                    break;
+                case ACTION_CALL_BEGIN: {
+                    const Symbol& callee = symbols_.lookup(lastSymbol_);
+                    calls_.push_back(callee.kind == SymbolKind::Function && callee.type != TokenKind::VOIDTK);
+                    break;
+                }
+                case ACTION_CALL_END: {
+                    bool hasValue = !calls_.empty() && calls_.back();
+                    if (!calls_.empty()) calls_.pop_back();
+                    out_.write(hasValue ? "<有返回值函数调用语句>\n" : "<无返回值函数调用语句>\n");
+                    break;
+                }
+            }
+        } else if (s >= LL1_END) {
+            const std::string& marker = g_.nonterminals[s - LL1_END].marker;
+            out_.write(marker);
+            out_.put('\n');
+        } else {
+            // 非终结符：查表选候选，右部逆序入栈
+            uint16_t a = s - LL1_NONTERMINAL;
+            const LL1Nonterminal& nt = g_.nonterminals[a];
+            int32_t entry = g_.table[a * LL1_TERMINALS + (uint16_t)ts_.kind()];
+            if (entry >= LL1Grammar::CONFLICT) {
+                int32_t chosen = LL1Grammar::NO_ENTRY;
+                for (uint16_t k : g_.conflicts[entry - LL1Grammar::CONFLICT]) {
+                    if (guardHolds(nt.alternatives[k].guard)) {
+                        chosen = k;
+                        break;
+                    }
+                }
+                entry = chosen;
+            }
+            // 没有候选时与递归子程序法一样继续往下分析，在更深处报告错误：可空的取推出空串的候选，只有一个候选的取它
+            if (entry == LL1Grammar::NO_ENTRY) entry = nt.emptyAlternative;
+            if (entry == LL1Grammar::NO_ENTRY && nt.alternatives.size() == 1) entry = 0;
+            if (entry == LL1Grammar::NO_ENTRY) {
+                // 没有可用的候选：记录错误，跳过当前单词，放弃这个非终结符
+                failExpecting(nt);
+                if (!ts_.at(TokenKind::NONE)) ts_.consume();
+                continue;
+            }
+            const LL1Alternative& alt = nt.alternatives[entry];
+            const uint16_t* push = g_.pushes.data() + alt.pushBegin;
+            stack_.insert(stack_.end(), push, push + alt.pushLength);
+        }
+    }
+    if (!ts_.at(TokenKind::NONE)) fail("文件结尾");
+    return error_.empty();
+}
@@ -0,0 +1,114 @@
+#ifndef SYNTACTIC_LL1_H
+#define SYNTACTIC_LL1_H
+
+// 表驱动的 LL(1) 语法分析：由文法描述计算 FIRST / FOLLOW 集，生成预测分析表，用显式栈分析，
+// 不递归，嵌套再深也不会栈溢出。输出与递归子程序法（parser.cpp）相同：语义动作按同样的作用域把定义记入
+// 同一种符号表（symbol_table.h），函数调用语句按同样的规则区分有无返回值。
+//
+// 文法描述的写法（见 main.cpp 的 grammarRules）：
+//   非终结符 [<成分名>] ::= 候选 | 候选 ... ;
+//   候选由空白分隔的符号组成：大写的类别码（IDENFR、SEMICN ...）是终结符，其他名字是非终结符，
+//   ε 表示空；@名字 是语义动作；候选开头可以写预读条件 ?k=类别码 / ?k!=类别码（k 为向后看的单词数，最多 3）。
+//   写了 <成分名> 的非终结符分析结束时输出该名字。第一条规则的左部是开始符号。
+// 同一格中有多个候选（LL(1) 冲突）时按书写顺序取第一个满足预读条件的候选，
+// 文法中少数需要多看几个单词的地方（函数调用 / 赋值、变量说明 / 函数定义）用预读条件区分，
+// 悬挂 else 之类的冲突取先写的候选。
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "interner.h"
+#include "source_io.h"
+#include "symbol_table.h"
+#include "token_stream.h"
+
+// 符号编码：终结符为类别码（NONE 表示输入结束），非终结符、"非终结符结束"和语义动作各占一段
+const uint16_t LL1_TERMINALS = (uint16_t)TokenKind::NONE + 1;
+const uint16_t LL1_NONTERMINAL = 0x100;
+const uint16_t LL1_END = 0x4000;
+const uint16_t LL1_ACTION = 0x8000;
+
+// 语义动作
+enum LL1Action : uint16_t {
+    ACTION_DEFINE_VALUE_FUNCTION, // @define：刚读到的标识符是有返回值函数的名字
+    ACTION_DEFINE_VOID_FUNCTION,  // @void：刚读到的标识符是无返回值函数的名字
+    ACTION_DEFINE_OBJECT,         // @var：刚读到的标识符是常量、变量或参数的名字
+    ACTION_SCOPE_BEGIN,           // @scope：进入函数的作用域
+    ACTION_SCOPE_END,             // @endscope：退出函数的作用域
+    ACTION_CALL_BEGIN,            // @callee：刚读到的标识符是被调函数
+    ACTION_CALL_END,              // @call：调用结束，按被调函数输出有 / 无返回值函数调用语句
+    ACTION_COUNT
+};
+
+// 预读条件：向后第 offset 个单词是（equal）/ 不是 kind；offset 为 0 表示没有条件
+struct LL1Guard {
+    uint8_t offset = 0;
+    bool equal = true;
+    TokenKind kind = TokenKind::NONE;
+};
+
+struct LL1Alternative {
+    std::vector<uint16_t> symbols;
+    LL1Guard guard;
+    // 选中后压栈的内容在 LL1Grammar::pushes 中的位置：右部逆序，最底下是"非终结符结束"（有成分名时）
+    uint32_t pushBegin = 0, pushLength = 0;
+};
+
+struct LL1Nonterminal {
+    std::string name;
+    std::string marker; // 分析结束时输出的成分名，可以为空
+    std::vector<LL1Alternative> alternatives;
+    bool nullable = false;
+    uint64_t first = 0;  // 按类别码的位集合
+    uint64_t follow = 0;
+    // 可空时推出空串的候选（表中没有候选时取它，由后面的符号报告错误），不可空时为 -1
+    int32_t emptyAlternative = -1;
+};
+
+struct LL1Grammar {
+    std::vector<LL1Nonterminal> nonterminals; // 第 0 个是开始符号
+    // table[A * LL1_TERMINALS + t]：当前单词为 t 时非终结符 A 的候选。
+    // 只有一个不带预读条件的候选时为它的序号；没有候选时为 NO_ENTRY；
+    // 否则为 CONFLICT + i，conflicts[i] 是按书写顺序排列的候选
+    static constexpr int32_t NO_ENTRY = -1;
+    static constexpr int32_t CONFLICT = 0x10000;
+    std::vector<int32_t> table;
+    std::vector<std::vector<uint16_t>> conflicts;
+    std::vector<uint16_t> pushes;
+};
+
+// 解析文法描述并生成分析表；描述有误或某个非终结符未定义时返回 false
+bool buildLL1Grammar(std::string_view description, LL1Grammar& grammar, std::string& error);
+
+class LL1Parser {
+public:
+    LL1Parser(const LL1Grammar& grammar, TokenStream& tokens, OutputBuffer& out)
+        : g_(grammar), ts_(tokens), out_(out) {
+        ts_.internIdentifiers(&names_);
+    }
+
+    // 分析整个程序；遇到不符合文法的单词时记录第一处错误并继续
+    bool parse();
+
+    const std::string& error() const { return error_; }
+
+private:
+    bool guardHolds(const LL1Guard& guard);
+    void fail(std::string_view what);
+    void failExpecting(const LL1Nonterminal& nt);
+    void define(Symbol symbol);
+
+    const LL1Grammar& g_;
+    TokenStream& ts_;
+    OutputBuffer& out_;
+    std::vector<uint16_t> stack_;
+    uint32_t lastSymbol_ = Interner::NONE; // 最近接受的标识符的编号
+    Interner names_;
+    SymbolTable symbols_;
+    std::vector<bool> calls_;              // 正在分析的调用的被调函数是否有返回值
+    std::string error_;
+};
+
+#endif
@@ -1 +1,256 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <vector>
+
+#include "ast.h"
+#include "lexer.h"
+#include "ll1.h"
+#include "parallel_parser.h"
+#include "parser.h"
+#include "pipeline.h"
+#include "source_io.h"
+#include "token_stream.h"
+
+using namespace std;
+
+// LL(1) 分析使用的文法（写法见 ll1.h），与 README 中的文法等价：去掉了左递归和公共左因子，
+// 重复部分写成右递归的 ...More，写了 <成分名> 的非终结符与递归子程序法中输出成分名的函数一一对应；
+// 语义动作在递归子程序法定义名字、进出作用域的同样位置维护符号表
+const char* const grammarRules = R"(
+Program <程序> ::= ConstDeclOpt VarDeclOpt FuncDefs MainFunc ;
+ConstDeclOpt ::= ConstDecl | ε ;
+ConstDecl <常量说明> ::= CONSTTK ConstDef SEMICN ConstDeclMore ;
+ConstDeclMore ::= CONSTTK ConstDef SEMICN ConstDeclMore | ε ;
+ConstDef <常量定义> ::= INTTK IDENFR @var ASSIGN Integer IntConstMore | CHARTK IDENFR @var ASSIGN CHARCON CharConstMore ;
+IntConstMore ::= COMMA IDENFR @var ASSIGN Integer IntConstMore | ε ;
+CharConstMore ::= COMMA IDENFR @var ASSIGN CHARCON CharConstMore | ε ;
+Integer <整数> ::= Sign UnsignedInt ;
+Sign ::= PLUS | MINU | ε ;
+UnsignedInt <无符号整数> ::= INTCON ;
+
+VarDeclOpt ::= ?2!=LPARENT VarDecl | ε ;
+VarDecl <变量说明> ::= VarDef SEMICN VarDeclMore ;
+VarDeclMore ::= ?2!=LPARENT VarDef SEMICN VarDeclMore | ε ;
+VarDef <变量定义> ::= TypeId VarItem VarItemMore ;
+VarItem ::= IDENFR @var ArrayDim ;
+ArrayDim ::= LBRACK UnsignedInt RBRACK | ε ;
+VarItemMore ::= COMMA VarItem VarItemMore | ε ;
+TypeId ::= INTTK | CHARTK ;
+
+FuncDefs ::= ValueFunc FuncDefs | ?1!=MAINTK VoidFunc FuncDefs | ε ;
+ValueFunc <有返回值函数定义> ::= DeclHead @scope LPARENT ParamList RPARENT LBRACE Compound RBRACE @endscope ;
+DeclHead <声明头部> ::= TypeId IDENFR @define ;
+VoidFunc <无返回值函数定义> ::= VOIDTK IDENFR @void @scope LPARENT ParamList RPARENT LBRACE Compound RBRACE @endscope ;
+ParamList <参数表> ::= TypeId IDENFR @var ParamMore | ε ;
+ParamMore ::= COMMA TypeId IDENFR @var ParamMore | ε ;
+MainFunc <主函数> ::= VOIDTK MAINTK LPARENT RPARENT LBRACE @scope Compound @endscope RBRACE ;
+Compound <复合语句> ::= ConstDeclOpt VarDeclOpt StatementList ;
+
+StatementList <语句列> ::= Statements ;
+Statements ::= Statement Statements | ε ;
+Statement <语句> ::= IfStmt | LoopStmt | LBRACE StatementList RBRACE
+    | ?1=LPARENT Call SEMICN | Assign SEMICN | ReadStmt SEMICN | WriteStmt SEMICN | ReturnStmt SEMICN | SEMICN ;
+Assign <赋值语句> ::= IDENFR ArrayIndex ASSIGN Expression ;
+ArrayIndex ::= LBRACK Expression RBRACK | ε ;
+IfStmt <条件语句> ::= IFTK LPARENT Condition RPARENT Statement ElsePart ;
+ElsePart ::= ELSETK Statement | ε ;
+Condition <条件> ::= Expression RelTail ;
+RelTail ::= RelOp Expression | ε ;
+RelOp ::= LSS | LEQ | GRE | GEQ | EQL | NEQ ;
+LoopStmt <循环语句> ::= WHILETK LPARENT Condition RPARENT Statement
+    | DOTK Statement WHILETK LPARENT Condition RPARENT
+    | FORTK LPARENT IDENFR ASSIGN Expression SEMICN Condition SEMICN IDENFR ASSIGN IDENFR AddOp Step RPARENT Statement ;
+Step <步长> ::= UnsignedInt ;
+Call ::= IDENFR @callee LPARENT ValueParams RPARENT @call ;
+ValueCall <有返回值函数调用语句> ::= IDENFR LPARENT ValueParams RPARENT ;
+ValueParams <值参数表> ::= Expression ExprMore | ε ;
+ExprMore ::= COMMA Expression ExprMore | ε ;
+ReadStmt <读语句> ::= SCANFTK LPARENT IDENFR IdentMore RPARENT ;
+IdentMore ::= COMMA IDENFR IdentMore | ε ;
+WriteStmt <写语句> ::= PRINTFTK LPARENT WriteArgs RPARENT ;
+WriteArgs ::= String WriteMore | Expression ;
+String <字符串> ::= STRCON ;
+WriteMore ::= COMMA Expression | ε ;
+ReturnStmt <返回语句> ::= RETURNTK ReturnValue ;
+ReturnValue ::= LPARENT Expression RPARENT | ε ;
+
+Expression <表达式> ::= Sign Term TermMore ;
+TermMore ::= AddOp Term TermMore | ε ;
+AddOp ::= PLUS | MINU ;
+Term <项> ::= Factor FactorMore ;
+FactorMore ::= MulOp Factor FactorMore | ε ;
+MulOp ::= MULT | DIV ;
+Factor <因子> ::= ?1=LPARENT ValueCall | IDENFR ArrayIndex | LPARENT Expression RPARENT | Integer | CHARCON ;
+)";
+
+// 事先保存好的单词序列，用于测量"先词法分析、再语法分析"的耗时
+struct TokenVector {
+    const std::vector<Token>& tokens;
+    size_t pos = 0;
+
+    bool next(Token& tok) {
+        if (pos == tokens.size()) return false;
+        tok = tokens[pos++];
+        return true;
+    }
+};
+
+// 用递归子程序法分析一遍（输出缓冲区未打开，输出被丢弃），返回是否成功
+template <class Source>
+bool parseFrom(Source& source) {
+    OutputBuffer discard;
+    TokenStream tokens(source, discard);
+    Parser parser(tokens, discard);
+    return parser.parseProgram();
+}
+
+void reportTime(const char* mode, std::chrono::steady_clock::time_point start, size_t bytes) {
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    cerr << mode << ": " << ms << " ms, " << bytes / 1048576.0 / (ms / 1000) << " MB/s";
+}
+
+// 比较三种方式从读入源程序到分析完的耗时：先词法分析出全部单词再语法分析、
+// 单线程边词法分析边语法分析、流水线（不同的每批单词数）
+void bench(const SourceFile& source, size_t queueBatches) {
+    using Clock = std::chrono::steady_clock;
+    cerr << "input: " << source.size() / 1024 << " KB, " << std::thread::hardware_concurrency() << " hardware threads"
+         << endl;
+
+    Clock::time_point start = Clock::now();
+    std::vector<Token> all;
+    Lexer lexer(source.data(), source.size());
+    for (Token tok; lexer.next(tok);) all.push_back(tok);
+    TokenVector saved{all};
+    parseFrom(saved);
+    reportTime("sequential", start, source.size());
+    cerr << ", " << all.size() << " tokens (" << all.capacity() * sizeof(Token) / 1024 << " KB)" << endl;
+
+    start = Clock::now();
+    Lexer streaming(source.data(), source.size());
+    parseFrom(streaming);
+    reportTime("streaming", start, source.size());
+    cerr << endl;
+
+    for (size_t batch : {16, 64, 256, 1024, 4096}) {
+        start = Clock::now();
+        size_t producerWaits, consumerWaits;
+        {
+            PipelinedLexer pipelined(source.data(), source.size(), batch, queueBatches);
+            parseFrom(pipelined);
+            producerWaits = pipelined.producerWaits();
+            consumerWaits = pipelined.consumerWaits();
+        }
+        char mode[32];
+        snprintf(mode, sizeof(mode), "pipeline batch=%zu", batch);
+        reportTime(mode, start, source.size());
+        cerr << ", waits: lexer " << producerWaits << ", parser " << consumerWaits << endl;
+    }
+}
+
+// 在标准错误输出语法树的规模，并把树写入 ast.txt
+bool writeAst(const ast::Ast& tree) {
+    cerr << "ast: " << tree.nodes.size() << " nodes in " << tree.nodes.blockCount() << " blocks ("
+         << tree.nodes.bytes() / 1024 << " KB), " << tree.symbols.size() << " symbols, " << tree.strings.size()
+         << " strings (" << (tree.symbols.bytes() + tree.strings.bytes()) / 1024 << " KB)" << endl;
+    OutputBuffer astOut;
+    if (!astOut.open("ast.txt")) {
+        cerr << "无法创建输出文件 ast.txt" << endl;
+        return false;
+    }
+    ast::writeTree(tree, astOut);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    // --ast：同时建立语法树，写入 ast.txt，并在标准错误输出结点数和占用的内存
+    // --ll1：改用由 grammarRules 生成的 LL(1) 分析表和显式栈分析（不建语法树），输出相同
+    // --pipeline：词法分析在单独的线程上运行，单词按批经无锁队列交给语法分析，输出相同
+    // --batch N：流水线每批的单词数，默认 256；--queue N：队列中最多的批数，默认 64
+    // --bench：比较先词法后语法、单线程流式、流水线三种方式的耗时（输出到标准错误，不写 output.txt）
+    // --parallel：按函数定义切分，多线程并行分析（递归子程序法），输出与整体分析相同
+    // -j <线程数>：并行分析的线程数，默认使用全部核心；--chunk <字节数>：每组函数的大小，默认 64 KB
+    // --check：同时做语义检查（标识符先定义后使用、不重复定义、不给常量赋值），有语义错误时返回 1
+    bool buildAst = false;
+    bool ll1 = false;
+    bool pipeline = false;
+    bool benchmark = false;
+    size_t batchSize = 256;
+    size_t queueBatches = 64;
+    bool parallel = false;
+    unsigned threads = 0;
+    size_t chunkSize = 64 << 10;
+    bool check = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ast") == 0) buildAst = true;
+        else if (strcmp(argv[i], "--ll1") == 0) ll1 = true;
+        else if (strcmp(argv[i], "--pipeline") == 0) pipeline = true;
+        else if (strcmp(argv[i], "--bench") == 0) benchmark = true;
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) batchSize = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--queue") == 0 && i + 1 < argc) queueBatches = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--parallel") == 0) parallel = true;
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) threads = (unsigned)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc) chunkSize = (size_t)atoll(argv[++i]);
+        else if (strcmp(argv[i], "--check") == 0) check = true;
+    }
+
+    SourceFile source;
+    if (!source.open("testfile.txt")) {
+        cerr << "无法打开输入文件 testfile.txt" << endl;
+        return 1;
+    }
+    if (benchmark) {
+        bench(source, queueBatches);
+        return 0;
+    }
+    OutputBuffer out;
+    if (!out.open("output.txt")) {
+        cerr << "无法创建输出文件 output.txt" << endl;
+        return 1;
+    }
+
+    // 词法分析器按需产生单词，语法分析器通过固定大小的预读缓冲区取用，不保存整个单词序列；
+    // 流水线模式下单词来自另一个线程上的词法分析器
+    Lexer lexer(source.data(), source.size());
+    std::unique_ptr<PipelinedLexer> pipelined;
+    if (pipeline) pipelined = std::make_unique<PipelinedLexer>(source.data(), source.size(), batchSize, queueBatches);
+    TokenStream tokens = pipelined ? TokenStream(*pipelined, out) : TokenStream(lexer, out);
+    if (ll1) {
+        LL1Grammar grammar;
+        string error;
+        if (!buildLL1Grammar(grammarRules, grammar, error)) {
+            cerr << error << endl;
+            return 1;
+        }
+        LL1Parser parser(grammar, tokens, out);
+        if (!parser.parse()) {
+            cerr << parser.error() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    ast::Ast tree;
+    string semanticError;
+    // 并行分析失败（结构不完整或有语法错误）时不输出任何内容，改用整体分析给出相同的输出和错误信息
+    if (!parallel || !parseParallel(source.data(), source.size(), threads, chunkSize, out, buildAst ? &tree : nullptr,
+                                    check ? &semanticError : nullptr)) {
+        tree.clear();
+        Parser parser(tokens, out, buildAst ? &tree : nullptr);
+        if (check) parser.enableChecks();
+        if (!parser.parseProgram()) {
+            cerr << parser.error() << endl;
+            return 1;
+        }
+        semanticError = parser.semanticError();
+    }
+    if (buildAst && !writeAst(tree)) return 1;
+    if (!semanticError.empty()) {
+        cerr << semanticError << endl;
+        return 1;
+    }
+    return 0;
+}
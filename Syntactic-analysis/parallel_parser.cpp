@@ -0,0 +1,163 @@
+#include "parallel_parser.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lexer.h"
+#include "parallel_lex.h"
+#include "parser.h"
+#include "token_stream.h"
+
+namespace {
+
+struct FunctionSpan {
+    const char* begin;
+    const char* end;
+    std::string_view name;
+    TokenKind type; // 返回类型；主函数（及名字不是标识符的函数）为 NONE
+};
+
+struct Layout {
+    const char* globalsEnd = nullptr;    // 常量说明、变量说明在 [data, globalsEnd) 中
+    std::vector<FunctionSpan> functions; // 最后一个是主函数
+};
+
+bool isType(TokenKind kind) { return kind == TokenKind::INTTK || kind == TokenKind::CHARTK; }
+
+// 预扫描，不符合"全局说明 + 若干函数定义 + 主函数"的结构时返回 false
+bool findFunctions(const char* data, size_t size, Layout& layout) {
+    Lexer lexer(data, size);
+    Token before2, before1, tok; // 前两个单词和当前单词
+    bool inFunction = false;
+    bool sawMain = false;
+    int depth = 0;
+    size_t outside = 0; // 上一个函数结束后的单词数
+    while (lexer.next(tok)) {
+        if (inFunction) {
+            if (tok.kind == TokenKind::LBRACE) {
+                depth++;
+            } else if (tok.kind == TokenKind::RBRACE) {
+                if (depth == 0) return false;
+                if (--depth == 0) {
+                    layout.functions.back().end = tok.text.data() + tok.text.size();
+                    inFunction = false;
+                    outside = 0;
+                }
+            }
+        } else if (tok.kind == TokenKind::LPARENT && (isType(before2.kind) || before2.kind == TokenKind::VOIDTK) &&
+                   (before1.kind == TokenKind::IDENFR || before1.kind == TokenKind::MAINTK)) {
+            // 类型 标识符 '('：函数定义开头；函数之间除下一个函数的 类型 标识符 外不能有别的单词
+            if (sawMain || (!layout.functions.empty() && outside != 2)) return false;
+            if (layout.functions.empty()) layout.globalsEnd = before2.text.data();
+            sawMain = before2.kind == TokenKind::VOIDTK && before1.kind == TokenKind::MAINTK;
+            TokenKind type = before1.kind == TokenKind::IDENFR ? before2.kind : TokenKind::NONE;
+            layout.functions.push_back({before2.text.data(), nullptr, before1.text, type});
+            inFunction = true;
+        } else if (tok.kind == TokenKind::LBRACE || tok.kind == TokenKind::RBRACE) {
+            return false;
+        } else {
+            outside++;
+        }
+        before2 = before1;
+        before1 = tok;
+    }
+    return sawMain && !inFunction && outside == 0;
+}
+
+// 一组的分析结果
+struct Part {
+    OutputBuffer out;
+    ast::Ast tree;
+    std::vector<ast::NodeId> nodes; // 本组顶层的结点（说明或函数）
+    std::string semanticError;
+    bool ok = false;
+};
+
+} // namespace
+
+bool parseParallel(const char* data, size_t size, unsigned threads, size_t chunkSize, OutputBuffer& out,
+                   ast::Ast* tree, std::string* checkError) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    Layout layout;
+    if (!findFunctions(data, size, layout)) return false;
+
+    // 分组：groupBegin[g] 是第 g 组的第一个函数，第 0 组之前是全局说明
+    std::vector<size_t> groupBegin;
+    for (size_t i = 0; i < layout.functions.size(); i++) {
+        if (groupBegin.empty() || layout.functions[i].begin - layout.functions[groupBegin.back()].begin >= (ptrdiff_t)chunkSize) {
+            groupBegin.push_back(i);
+        }
+    }
+    groupBegin.push_back(layout.functions.size());
+    size_t groups = groupBegin.size() - 1;
+
+    std::vector<std::unique_ptr<Part>> parts(groups + 1);
+    for (auto& part : parts) {
+        part = std::make_unique<Part>();
+        part->out.openMemory();
+    }
+
+    // 全局说明先在本线程分析，各组的符号表从它的全局定义开始
+    Part& globals = *parts[0];
+    Lexer globalLexer(data, layout.globalsEnd - data);
+    TokenStream globalTokens(globalLexer, globals.out);
+    Parser globalParser(globalTokens, globals.out, tree ? &globals.tree : nullptr);
+    if (checkError) globalParser.enableChecks();
+    ast::NodeId consts, vars;
+    globalParser.parseGlobals(consts, vars);
+    globals.nodes = {consts, vars};
+    globals.semanticError = globalParser.semanticError();
+    globals.ok = globalParser.error().empty() && globalParser.atEnd();
+    if (!globals.ok) return false;
+
+    parallel_lex::parallelFor(groups, threads, [&](size_t g) {
+        Part& part = *parts[g + 1];
+        size_t first = groupBegin[g], last = groupBegin[g + 1];
+        Lexer lexer(layout.functions[first].begin, layout.functions[last - 1].end - layout.functions[first].begin);
+        TokenStream tokens(lexer, part.out);
+        Parser parser(tokens, part.out, tree ? &part.tree : nullptr);
+        if (checkError) parser.enableChecks();
+        // 符号表与整体分析到这里时相同：全局说明和之前各组的函数（本组的函数在分析时依次定义）
+        parser.defineGlobals(globalParser);
+        for (size_t i = 0; i < first; i++) {
+            if (layout.functions[i].type != TokenKind::NONE) {
+                parser.defineFunction(layout.functions[i].name, layout.functions[i].type);
+            }
+        }
+        for (size_t i = first; i < last; i++) part.nodes.push_back(parser.parseFunction());
+        part.semanticError = parser.semanticError();
+        part.ok = parser.error().empty() && parser.atEnd();
+    });
+    for (const auto& part : parts) {
+        if (!part->ok) return false;
+    }
+    if (checkError) {
+        checkError->clear();
+        for (const auto& part : parts) {
+            if (checkError->empty()) *checkError = part->semanticError;
+        }
+    }
+
+    for (const auto& part : parts) out.write(part->out.contents());
+    out.write("<程序>\n");
+
+    if (tree) {
+        // 各组的结点依次追加，顶层结点连成 Program 的子结点
+        ast::Node program;
+        program.kind = ast::NodeKind::Program;
+        ast::NodeId last = ast::NIL;
+        for (const auto& part : parts) {
+            ast::NodeId base = ast::appendNodes(*tree, part->tree);
+            for (ast::NodeId id : part->nodes) {
+                if (id == ast::NIL) continue;
+                if (last == ast::NIL) program.firstChild = id + base;
+                else tree->nodes[last].nextSibling = id + base;
+                last = id + base;
+            }
+        }
+        tree->root = tree->nodes.push(program);
+    }
+    return true;
+}
@@ -0,0 +1,26 @@
+#ifndef SYNTACTIC_PARALLEL_PARSER_H
+#define SYNTACTIC_PARALLEL_PARSER_H
+
+// 按函数并行的语法分析：
+//   1. 预扫描：用词法分析器扫一遍单词，只数大括号的层数。层数为 0 时的 类型 标识符 '(' 是函数定义的开头，
+//      使层数回到 0 的 '}' 是函数定义的结尾；同时记下每个函数的名字和返回类型。
+//   2. 先分析程序开头的常量说明、变量说明；函数按源程序顺序每约 chunkSize 字节分为一组，
+//      各组在工作线程上用自己的词法分析器、输出缓冲区、语法树和符号表分析。各组的符号表事先放入
+//      全局说明和预扫描得到的之前各组的函数，与整体分析到这里时相同，各组不必等待前面的组。
+//   3. 全部成功后按顺序合并各组的输出和语法树，结果与整体分析（Parser::parseProgram）相同。
+// 预扫描找不到完整的函数结构（括号不配对、函数之间有多余的单词、主函数不在最后等），
+// 或某一组分析出错时返回 false，不写任何输出，由调用者改用整体分析，得到相同的输出和错误信息。
+
+#include <cstddef>
+#include <string>
+
+#include "ast.h"
+#include "source_io.h"
+
+// 分析 [data, data + size)，输出写入 out，给出 tree 时同时建立语法树（tree 应为空），
+// 给出 checkError 时同时做语义检查（见 Parser::enableChecks），第一处语义错误存入其中（没有时为空）。
+// threads 为 0 时使用全部核心
+bool parseParallel(const char* data, size_t size, unsigned threads, size_t chunkSize, OutputBuffer& out,
+                   ast::Ast* tree, std::string* checkError = nullptr);
+
+#endif
@@ -0,0 +1,585 @@
+#include "parser.h"
+
+void Parser::expect(K kind) {
+    if (ts_.at(kind)) {
+        ts_.consume();
+        return;
+    }
+    fail(tokenName(kind));
+}
+
+void Parser::fail(std::string_view what) {
+    if (!error_.empty()) return;
+    const Token& tok = ts_.peek();
+    error_ = "语法错误：应为 " + std::string(what) + "，实际为 ";
+    error_ += tok.kind == K::NONE ? std::string("文件结尾") : std::string(tokenName(tok.kind)) + " " + std::string(tok.text);
+}
+
+void Parser::semanticFail(std::string_view what, uint32_t id) {
+    if (!semanticError_.empty()) return;
+    semanticError_ = "语义错误：" + std::string(names().name(id)) + " " + std::string(what);
+}
+
+void Parser::checkObject(uint32_t id, bool assigned) {
+    if (!check_) return;
+    const Symbol& symbol = symbols_.lookup(id);
+    if (symbol.kind == SymbolKind::None) semanticFail("未定义", id);
+    else if (symbol.kind == SymbolKind::Function) semanticFail("是函数，不能作为变量使用", id);
+    else if (assigned && symbol.kind == SymbolKind::Const) semanticFail("是常量，不能赋值", id);
+}
+
+void Parser::checkFunction(uint32_t id) {
+    if (!check_) return;
+    const Symbol& symbol = symbols_.lookup(id);
+    if (symbol.kind == SymbolKind::None) semanticFail("未定义", id);
+    else if (symbol.kind != SymbolKind::Function) semanticFail("不是函数", id);
+}
+
+void Parser::defineGlobals(const Parser& other) {
+    const Interner& from = other.names();
+    for (uint32_t id = 0; id < from.size(); id++) {
+        const Symbol& symbol = other.symbols_.lookup(id);
+        if (symbol.kind != SymbolKind::None) symbols_.define(names().intern(from.name(id)), symbol);
+    }
+}
+
+// ＜程序＞ ::= ［＜常量说明＞］［＜变量说明＞］{＜有返回值函数定义＞|＜无返回值函数定义＞}＜主函数＞
+bool Parser::parseProgram() {
+    Children parts;
+    NodeId consts, vars;
+    parseGlobals(consts, vars);
+    append(parts, consts);
+    append(parts, vars);
+    while (atType() || (ts_.at(K::VOIDTK) && !ts_.at(K::MAINTK, 1))) append(parts, parseFunction());
+    append(parts, mainFunc());
+    mark("<程序>");
+    if (tree_) tree_->root = make(NodeKind::Program, K::NONE, parts);
+    if (!ts_.at(K::NONE)) fail("文件结尾");
+    return error_.empty();
+}
+
+void Parser::parseGlobals(NodeId& consts, NodeId& vars) {
+    consts = ts_.at(K::CONSTTK) ? constDecl() : ast::NIL;
+    vars = atVarDef() ? varDecl() : ast::NIL;
+}
+
+Parser::NodeId Parser::parseFunction() {
+    if (atType()) return funcWithReturn();
+    if (ts_.at(K::VOIDTK) && !ts_.at(K::MAINTK, 1)) return funcVoid();
+    return mainFunc();
+}
+
+// ＜常量说明＞ ::= const＜常量定义＞;{ const＜常量定义＞;}
+Parser::NodeId Parser::constDecl() {
+    Children defs;
+    do {
+        expect(K::CONSTTK);
+        constDef(defs);
+        expect(K::SEMICN);
+    } while (ts_.at(K::CONSTTK));
+    mark("<常量说明>");
+    return make(NodeKind::ConstDecl, K::NONE, defs);
+}
+
+// ＜常量定义＞ ::= int＜标识符＞＝＜整数＞{,＜标识符＞＝＜整数＞} | char＜标识符＞＝＜字符＞{,＜标识符＞＝＜字符＞}
+// 每个标识符一个 ConstDef 结点，加入 defs
+void Parser::constDef(Children& defs) {
+    K type = ts_.kind();
+    bool isInt = type == K::INTTK;
+    if (!isInt && type != K::CHARTK) fail("int 或 char");
+    else ts_.consume();
+    do {
+        uint32_t name = identifier();
+        declare(name, SymbolKind::Const, type);
+        expect(K::ASSIGN);
+        NodeId value;
+        if (isInt) {
+            value = integer();
+        } else {
+            Token tok = ts_.peek();
+            expect(K::CHARCON);
+            value = make(NodeKind::CharLit, K::NONE, Children(), tok.text.empty() ? 0 : (unsigned char)tok.text[0]);
+        }
+        append(defs, make(NodeKind::ConstDef, type, value, name));
+    } while (accept(K::COMMA));
+    mark("<常量定义>");
+}
+
+// ＜整数＞ ::= ［＋｜－］＜无符号整数＞
+Parser::NodeId Parser::integer() {
+    bool negative = ts_.at(K::MINU);
+    if (ts_.at(K::PLUS) || ts_.at(K::MINU)) ts_.consume();
+    uint32_t value = unsignedInt();
+    mark("<整数>");
+    return make(NodeKind::IntLit, K::NONE, Children(), negative ? 0u - value : value);
+}
+
+// ＜无符号整数＞，返回它的值（超出 32 位时回绕）
+uint32_t Parser::unsignedInt() {
+    uint32_t value = 0;
+    if (ts_.at(K::INTCON)) {
+        for (char c : ts_.peek().text) value = value * 10 + (uint32_t)(c - '0');
+    }
+    expect(K::INTCON);
+    mark("<无符号整数>");
+    return value;
+}
+
+// ＜变量说明＞ ::= ＜变量定义＞;{＜变量定义＞;}
+Parser::NodeId Parser::varDecl() {
+    Children defs;
+    do {
+        varDef(defs);
+        expect(K::SEMICN);
+    } while (atVarDef());
+    mark("<变量说明>");
+    return make(NodeKind::VarDecl, K::NONE, defs);
+}
+
+// ＜变量定义＞ ::= ＜类型标识符＞(＜标识符＞|＜标识符＞'['＜无符号整数＞']'){,(＜标识符＞|＜标识符＞'['＜无符号整数＞']')}
+// 每个标识符一个 VarDef 结点，加入 defs
+void Parser::varDef(Children& defs) {
+    K type = ts_.kind();
+    ts_.consume();
+    do {
+        uint32_t name = identifier();
+        declare(name, SymbolKind::Var, type);
+        NodeId length = ast::NIL;
+        if (ts_.at(K::LBRACK)) {
+            ts_.consume();
+            length = make(NodeKind::IntLit, K::NONE, Children(), unsignedInt());
+            expect(K::RBRACK);
+        }
+        append(defs, make(NodeKind::VarDef, type, length, name));
+    } while (accept(K::COMMA));
+    mark("<变量定义>");
+}
+
+// ＜声明头部＞ ::= int＜标识符＞ |char＜标识符＞
+void Parser::declHead(K& type, uint32_t& name) {
+    type = ts_.kind();
+    ts_.consume();
+    name = identifier();
+    declare(name, SymbolKind::Function, type);
+    mark("<声明头部>");
+}
+
+// ＜有返回值函数定义＞ ::= ＜声明头部＞'('＜参数表＞')' '{'＜复合语句＞'}'
+Parser::NodeId Parser::funcWithReturn() {
+    K type;
+    uint32_t name;
+    declHead(type, name);
+    Children parts;
+    symbols_.pushScope();
+    expect(K::LPARENT);
+    paramList(parts);
+    expect(K::RPARENT);
+    expect(K::LBRACE);
+    append(parts, compound());
+    expect(K::RBRACE);
+    symbols_.popScope();
+    mark("<有返回值函数定义>");
+    return make(NodeKind::Function, type, parts, name);
+}
+
+// ＜无返回值函数定义＞ ::= void＜标识符＞'('＜参数表＞')''{'＜复合语句＞'}'
+Parser::NodeId Parser::funcVoid() {
+    ts_.consume();
+    uint32_t name = identifier();
+    declare(name, SymbolKind::Function, K::VOIDTK);
+    Children parts;
+    symbols_.pushScope();
+    expect(K::LPARENT);
+    paramList(parts);
+    expect(K::RPARENT);
+    expect(K::LBRACE);
+    append(parts, compound());
+    expect(K::RBRACE);
+    symbols_.popScope();
+    mark("<无返回值函数定义>");
+    return make(NodeKind::Function, K::VOIDTK, parts, name);
+}
+
+// ＜参数表＞ ::= ＜类型标识符＞＜标识符＞{,＜类型标识符＞＜标识符＞}| ＜空＞
+void Parser::paramList(Children& params) {
+    if (atType()) {
+        do {
+            K type = ts_.kind();
+            if (atType()) ts_.consume();
+            else fail("int 或 char");
+            uint32_t name = identifier();
+            declare(name, SymbolKind::Var, type);
+            append(params, make(NodeKind::Param, type, Children(), name));
+        } while (accept(K::COMMA));
+    }
+    mark("<参数表>");
+}
+
+// ＜主函数＞ ::= void main‘(’‘)’ ‘{’＜复合语句＞‘}’
+Parser::NodeId Parser::mainFunc() {
+    expect(K::VOIDTK);
+    Token tok = ts_.peek();
+    expect(K::MAINTK);
+    expect(K::LPARENT);
+    expect(K::RPARENT);
+    expect(K::LBRACE);
+    symbols_.pushScope();
+    NodeId body = compound();
+    symbols_.popScope();
+    expect(K::RBRACE);
+    mark("<主函数>");
+    return make(NodeKind::Function, K::VOIDTK, body, tree_ ? tree_->symbols.intern(tok.text) : 0);
+}
+
+// ＜复合语句＞ ::= ［＜常量说明＞］［＜变量说明＞］＜语句列＞
+Parser::NodeId Parser::compound() {
+    Children parts;
+    if (ts_.at(K::CONSTTK)) append(parts, constDecl());
+    if (atType()) append(parts, varDecl());
+    statementList(parts);
+    mark("<复合语句>");
+    return make(NodeKind::Compound, K::NONE, parts);
+}
+
+// ＜语句列＞ ::= ｛＜语句＞｝
+void Parser::statementList(Children& statements) {
+    while (!ts_.at(K::RBRACE) && !ts_.at(K::NONE)) append(statements, statement());
+    mark("<语句列>");
+}
+
+// ＜语句＞ ::= ＜条件语句＞｜＜循环语句＞| '{'＜语句列＞'}'| ＜有返回值函数调用语句＞; |＜无返回值函数调用语句＞;
+//            ｜＜赋值语句＞;｜＜读语句＞;｜＜写语句＞;｜＜空＞;|＜返回语句＞;
+Parser::NodeId Parser::statement() {
+    NodeId node;
+    switch (ts_.kind()) {
+        case K::IFTK:
+            node = ifStatement();
+            break;
+        case K::WHILETK:
+        case K::DOTK:
+        case K::FORTK:
+            node = loopStatement();
+            break;
+        case K::LBRACE: {
+            ts_.consume();
+            Children statements;
+            statementList(statements);
+            expect(K::RBRACE);
+            node = make(NodeKind::Block, K::NONE, statements);
+            break;
+        }
+        case K::IDENFR:
+            // 标识符后是 '(' 为函数调用，否则为赋值
+            if (ts_.at(K::LPARENT, 1)) node = call(false);
+            else node = assignment();
+            expect(K::SEMICN);
+            break;
+        case K::SCANFTK:
+            node = readStatement();
+            expect(K::SEMICN);
+            break;
+        case K::PRINTFTK:
+            node = writeStatement();
+            expect(K::SEMICN);
+            break;
+        case K::RETURNTK:
+            node = returnStatement();
+            expect(K::SEMICN);
+            break;
+        case K::SEMICN:
+            ts_.consume();
+            node = make(NodeKind::Empty);
+            break;
+        default:
+            // 不能开始语句的单词：记录错误并跳过，保证分析能继续
+            fail("语句");
+            ts_.consume();
+            return ast::NIL;
+    }
+    mark("<语句>");
+    return node;
+}
+
+// ＜赋值语句＞ ::= ＜标识符＞＝＜表达式＞|＜标识符＞'['＜表达式＞']'=＜表达式＞
+Parser::NodeId Parser::assignment() {
+    uint32_t name = identifier();
+    checkObject(name, true);
+    NodeId target;
+    if (ts_.at(K::LBRACK)) {
+        ts_.consume();
+        target = make(NodeKind::Index, K::NONE, expression(), name);
+        expect(K::RBRACK);
+    } else {
+        target = make(NodeKind::Ident, K::NONE, Children(), name);
+    }
+    expect(K::ASSIGN);
+    Children parts;
+    append(parts, target);
+    append(parts, expression());
+    mark("<赋值语句>");
+    return make(NodeKind::Assign, K::NONE, parts);
+}
+
+// ＜条件语句＞ ::= if '('＜条件＞')'＜语句＞［else＜语句＞］
+Parser::NodeId Parser::ifStatement() {
+    Children parts;
+    ts_.consume();
+    expect(K::LPARENT);
+    append(parts, condition());
+    expect(K::RPARENT);
+    append(parts, statement());
+    if (ts_.at(K::ELSETK)) {
+        ts_.consume();
+        append(parts, statement());
+    }
+    mark("<条件语句>");
+    return make(NodeKind::If, K::NONE, parts);
+}
+
+// ＜条件＞ ::= ＜表达式＞＜关系运算符＞＜表达式＞ ｜＜表达式＞
+Parser::NodeId Parser::condition() {
+    Children parts;
+    append(parts, expression());
+    K op = K::NONE;
+    switch (ts_.kind()) {
+        case K::LSS:
+        case K::LEQ:
+        case K::GRE:
+        case K::GEQ:
+        case K::EQL:
+        case K::NEQ:
+            op = ts_.kind();
+            ts_.consume();
+            append(parts, expression());
+            break;
+        default:
+            break;
+    }
+    mark("<条件>");
+    return make(NodeKind::Condition, op, parts);
+}
+
+// ＜循环语句＞ ::= while '('＜条件＞')'＜语句＞| do＜语句＞while '('＜条件＞')'
+//               | for'('＜标识符＞＝＜表达式＞;＜条件＞;＜标识符＞＝＜标识符＞(+|-)＜步长＞')'＜语句＞
+Parser::NodeId Parser::loopStatement() {
+    Children parts;
+    NodeKind kind;
+    if (ts_.at(K::WHILETK)) {
+        kind = NodeKind::While;
+        ts_.consume();
+        expect(K::LPARENT);
+        append(parts, condition());
+        expect(K::RPARENT);
+        append(parts, statement());
+    } else if (ts_.at(K::DOTK)) {
+        kind = NodeKind::DoWhile;
+        ts_.consume();
+        append(parts, statement());
+        expect(K::WHILETK);
+        expect(K::LPARENT);
+        append(parts, condition());
+        expect(K::RPARENT);
+    } else {
+        kind = NodeKind::For;
+        ts_.consume();
+        expect(K::LPARENT);
+        {
+            Children init;
+            uint32_t name = identifier();
+            checkObject(name, true);
+            append(init, make(NodeKind::Ident, K::NONE, Children(), name));
+            expect(K::ASSIGN);
+            append(init, expression());
+            append(parts, make(NodeKind::Assign, K::NONE, init));
+        }
+        expect(K::SEMICN);
+        append(parts, condition());
+        expect(K::SEMICN);
+        {
+            // 标识符 = 标识符 (+|-) 步长
+            Children update;
+            uint32_t target = identifier();
+            checkObject(target, true);
+            append(update, make(NodeKind::Ident, K::NONE, Children(), target));
+            expect(K::ASSIGN);
+            Children operands;
+            uint32_t source = identifier();
+            checkObject(source, false);
+            append(operands, make(NodeKind::Ident, K::NONE, Children(), source));
+            K op = ts_.kind();
+            if (ts_.at(K::PLUS) || ts_.at(K::MINU)) ts_.consume();
+            else fail("+ 或 -");
+            append(operands, step());
+            append(update, make(NodeKind::Binary, op, operands));
+            append(parts, make(NodeKind::Assign, K::NONE, update));
+        }
+        expect(K::RPARENT);
+        append(parts, statement());
+    }
+    mark("<循环语句>");
+    return make(kind, K::NONE, parts);
+}
+
+// ＜步长＞ ::= ＜无符号整数＞
+Parser::NodeId Parser::step() {
+    uint32_t value = unsignedInt();
+    mark("<步长>");
+    return make(NodeKind::IntLit, K::NONE, Children(), value);
+}
+
+// ＜有返回值函数调用语句＞ / ＜无返回值函数调用语句＞ ::= ＜标识符＞'('＜值参数表＞')'
+// 两者写法相同。因子中只能是有返回值函数调用语句（inFactor）；语句中按被调函数当前可见的定义是否有返回值区分
+Parser::NodeId Parser::call(bool inFactor) {
+    uint32_t name = identifier();
+    checkFunction(name);
+    const Symbol& callee = symbols_.lookup(name);
+    bool hasValue = inFactor || (callee.kind == SymbolKind::Function && callee.type != K::VOIDTK);
+    Children args;
+    expect(K::LPARENT);
+    valueParams(args);
+    expect(K::RPARENT);
+    mark(hasValue ? "<有返回值函数调用语句>" : "<无返回值函数调用语句>");
+    return make(NodeKind::Call, hasValue ? K::INTTK : K::VOIDTK, args, name);
+}
+
+// ＜值参数表＞ ::= ＜表达式＞{,＜表达式＞}｜＜空＞
+void Parser::valueParams(Children& args) {
+    if (!ts_.at(K::RPARENT)) {
+        append(args, expression());
+        while (ts_.at(K::COMMA)) {
+            ts_.consume();
+            append(args, expression());
+        }
+    }
+    mark("<值参数表>");
+}
+
+// ＜读语句＞ ::= scanf '('＜标识符＞{,＜标识符＞}')'
+Parser::NodeId Parser::readStatement() {
+    Children targets;
+    ts_.consume();
+    expect(K::LPARENT);
+    do {
+        uint32_t name = identifier();
+        checkObject(name, true);
+        append(targets, make(NodeKind::Ident, K::NONE, Children(), name));
+    } while (accept(K::COMMA));
+    expect(K::RPARENT);
+    mark("<读语句>");
+    return make(NodeKind::Read, K::NONE, targets);
+}
+
+// ＜写语句＞ ::= printf '(' ＜字符串＞,＜表达式＞ ')'| printf '('＜字符串＞ ')'| printf '('＜表达式＞')'
+Parser::NodeId Parser::writeStatement() {
+    Children parts;
+    ts_.consume();
+    expect(K::LPARENT);
+    if (ts_.at(K::STRCON)) {
+        uint32_t text = tree_ ? tree_->strings.intern(ts_.peek().text) : 0;
+        ts_.consume();
+        mark("<字符串>");
+        append(parts, make(NodeKind::StrLit, K::NONE, Children(), text));
+        if (ts_.at(K::COMMA)) {
+            ts_.consume();
+            append(parts, expression());
+        }
+    } else {
+        append(parts, expression());
+    }
+    expect(K::RPARENT);
+    mark("<写语句>");
+    return make(NodeKind::Write, K::NONE, parts);
+}
+
+// ＜返回语句＞ ::= return['('＜表达式＞')']
+Parser::NodeId Parser::returnStatement() {
+    NodeId value = ast::NIL;
+    ts_.consume();
+    if (ts_.at(K::LPARENT)) {
+        ts_.consume();
+        value = expression();
+        expect(K::RPARENT);
+    }
+    mark("<返回语句>");
+    return make(NodeKind::Return, K::NONE, value);
+}
+
+// ＜表达式＞ ::= ［＋｜－］＜项＞{＜加法运算符＞＜项＞}
+// 运算左结合；开头的符号只作用于第一项
+Parser::NodeId Parser::expression() {
+    K sign = K::NONE;
+    if (ts_.at(K::PLUS) || ts_.at(K::MINU)) {
+        sign = ts_.kind();
+        ts_.consume();
+    }
+    NodeId left = term();
+    if (sign != K::NONE) left = make(NodeKind::Unary, sign, left);
+    while (ts_.at(K::PLUS) || ts_.at(K::MINU)) {
+        K op = ts_.kind();
+        ts_.consume();
+        Children operands;
+        append(operands, left);
+        append(operands, term());
+        left = make(NodeKind::Binary, op, operands);
+    }
+    mark("<表达式>");
+    return left;
+}
+
+// ＜项＞ ::= ＜因子＞{＜乘法运算符＞＜因子＞}
+Parser::NodeId Parser::term() {
+    NodeId left = factor();
+    while (ts_.at(K::MULT) || ts_.at(K::DIV)) {
+        K op = ts_.kind();
+        ts_.consume();
+        Children operands;
+        append(operands, left);
+        append(operands, factor());
+        left = make(NodeKind::Binary, op, operands);
+    }
+    mark("<项>");
+    return left;
+}
+
+// ＜因子＞ ::= ＜标识符＞｜＜标识符＞'['＜表达式＞']'|'('＜表达式＞')'｜＜整数＞|＜字符＞｜＜有返回值函数调用语句＞
+Parser::NodeId Parser::factor() {
+    NodeId node = ast::NIL;
+    switch (ts_.kind()) {
+        case K::IDENFR:
+            if (ts_.at(K::LPARENT, 1)) {
+                node = call(true);
+            } else {
+                uint32_t name = identifier();
+                checkObject(name, false);
+                if (ts_.at(K::LBRACK)) {
+                    ts_.consume();
+                    node = make(NodeKind::Index, K::NONE, expression(), name);
+                    expect(K::RBRACK);
+                } else {
+                    node = make(NodeKind::Ident, K::NONE, Children(), name);
+                }
+            }
+            break;
+        case K::LPARENT:
+            ts_.consume();
+            node = expression();
+            expect(K::RPARENT);
+            break;
+        case K::INTCON:
+        case K::PLUS:
+        case K::MINU:
+            node = integer();
+            break;
+        case K::CHARCON: {
+            std::string_view text = ts_.peek().text;
+            ts_.consume();
+            node = make(NodeKind::CharLit, K::NONE, Children(), text.empty() ? 0 : (unsigned char)text[0]);
+            break;
+        }
+        default:
+            fail("因子");
+            break;
+    }
+    mark("<因子>");
+    return node;
+}
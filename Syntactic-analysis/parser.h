@@ -0,0 +1,163 @@
+#ifndef SYNTACTIC_PARSER_H
+#define SYNTACTIC_PARSER_H
+
+// 递归子程序法的语法分析器：文法中每个语法成分对应一个函数（文法见 README）。
+// 单词由 TokenStream 按需取出并在接受时输出，要求输出的语法成分在分析结束时另起一行输出 <成分名>。
+// 给出 Ast 时同时建立语法树（见 ast.h），各函数返回所建结点的下标；不建树时返回 ast::NIL。
+// 标识符在从单词流取出时驻留为编号（建树时驻留到语法树的标识符表），常量、变量和函数的定义记入按编号
+// 查找的符号表（symbol_table.h），函数体是一层作用域；调用语句按被调函数的定义区分有 / 无返回值。
+
+#include <string>
+#include <string_view>
+
+#include "ast.h"
+#include "interner.h"
+#include "source_io.h"
+#include "symbol_table.h"
+#include "token_stream.h"
+
+class Parser {
+public:
+    Parser(TokenStream& tokens, OutputBuffer& out, ast::Ast* tree = nullptr) : ts_(tokens), out_(out), tree_(tree) {
+        ts_.internIdentifiers(&names());
+    }
+
+    // 分析整个程序，建树时根结点存入 tree->root；遇到不符合文法的单词时记录第一处错误，跳过该单词继续分析
+    bool parseProgram();
+
+    const std::string& error() const { return error_; }
+
+    // 同时做语义检查：标识符先定义后使用、同一作用域中不重复定义、不给常量赋值、调用的是函数。
+    // 只记录第一处语义错误，不影响语法分析和输出
+    void enableChecks() { check_ = true; }
+    const std::string& semanticError() const { return semanticError_; }
+
+    // 以下供并行分析（parallel_parser.h）分段使用，分析的内容与 parseProgram 的相应部分相同：
+    // 程序开头的常量说明和变量说明，没有的为 ast::NIL
+    void parseGlobals(ast::NodeId& consts, ast::NodeId& vars);
+    // 一个有返回值 / 无返回值函数定义或主函数
+    ast::NodeId parseFunction();
+    // 把 other 分析过的全局定义加入本分析器的全局作用域（other 的作用域应已全部退出）
+    void defineGlobals(const Parser& other);
+    // 在全局作用域中定义函数 name，type 为返回类型（同名已定义时保留原来的定义）
+    void defineFunction(std::string_view name, TokenKind type) {
+        symbols_.define(names().intern(name), Symbol{SymbolKind::Function, type});
+    }
+    bool atEnd() { return ts_.at(K::NONE); }
+
+private:
+    using K = TokenKind;
+    using NodeId = ast::NodeId;
+    using NodeKind = ast::NodeKind;
+
+    // 正在建立的子结点链表
+    struct Children {
+        NodeId first, last;
+        Children() : first(ast::NIL), last(ast::NIL) {}
+    };
+
+    void append(Children& list, NodeId child) {
+        if (!tree_ || child == ast::NIL) return;
+        if (list.first == ast::NIL) list.first = child;
+        else tree_->nodes[list.last].nextSibling = child;
+        list.last = child;
+    }
+
+    // 新建结点，payload 按结点种类解释（见 ast.h）
+    NodeId make(NodeKind kind, K op = K::NONE, Children children = Children(), uint32_t payload = 0) {
+        if (!tree_) return ast::NIL;
+        ast::Node node;
+        node.kind = kind;
+        node.op = op;
+        node.firstChild = children.first;
+        node.symbol = payload;
+        return tree_->nodes.push(node);
+    }
+
+    NodeId make(NodeKind kind, K op, NodeId child, uint32_t payload = 0) {
+        Children children;
+        append(children, child);
+        return make(kind, op, children, payload);
+    }
+
+    // 标识符表：建树时为语法树的标识符表
+    Interner& names() { return tree_ ? tree_->symbols : names_; }
+    const Interner& names() const { return tree_ ? tree_->symbols : names_; }
+
+    // 接受一个标识符，返回它的编号（当前单词不是标识符时驻留它的内容，只在出错时发生）
+    uint32_t identifier() {
+        uint32_t id = ts_.symbol();
+        if (id == Interner::NONE) id = names().intern(ts_.peek().text);
+        expect(K::IDENFR);
+        return id;
+    }
+
+    // 在当前作用域中定义标识符
+    void declare(uint32_t id, SymbolKind kind, K type) {
+        if (!symbols_.define(id, Symbol{kind, type}) && check_) semanticFail("重复定义", id);
+    }
+    // 语义检查：标识符用作常量 / 变量（assigned 为被赋值或读入，只能是变量）、用作函数名
+    void checkObject(uint32_t id, bool assigned);
+    void checkFunction(uint32_t id);
+    void semanticFail(std::string_view what, uint32_t id);
+
+    // 输出语法成分的名字
+    void mark(std::string_view name) {
+        out_.write(name);
+        out_.put('\n');
+    }
+
+    // 当前单词是 kind 时接受它并返回 true
+    bool accept(K kind) {
+        if (!ts_.at(kind)) return false;
+        ts_.consume();
+        return true;
+    }
+
+    // 当前单词应为 kind：接受它；否则记录错误（不接受，由调用者继续分析）
+    void expect(K kind);
+    void fail(std::string_view what);
+
+    bool atType() { return ts_.at(K::INTTK) || ts_.at(K::CHARTK); }
+    // 类型 标识符 '(' 开始的是函数定义，否则是变量定义
+    bool atVarDef() { return atType() && !ts_.at(K::LPARENT, 2); }
+
+    NodeId constDecl();
+    void constDef(Children& defs);
+    NodeId integer();
+    uint32_t unsignedInt();
+    NodeId varDecl();
+    void varDef(Children& defs);
+    void declHead(K& type, uint32_t& name);
+    NodeId funcWithReturn();
+    NodeId funcVoid();
+    void paramList(Children& params);
+    NodeId mainFunc();
+    NodeId compound();
+    void statementList(Children& statements);
+    NodeId statement();
+    NodeId assignment();
+    NodeId ifStatement();
+    NodeId condition();
+    NodeId loopStatement();
+    NodeId step();
+    NodeId call(bool inFactor);
+    void valueParams(Children& args);
+    NodeId readStatement();
+    NodeId writeStatement();
+    NodeId returnStatement();
+    NodeId expression();
+    NodeId term();
+    NodeId factor();
+
+    TokenStream& ts_;
+    OutputBuffer& out_;
+    ast::Ast* tree_;
+    Interner names_; // 不建树时的标识符表
+    SymbolTable symbols_;
+    bool check_ = false;
+    std::string error_;
+    std::string semanticError_;
+};
+
+#endif
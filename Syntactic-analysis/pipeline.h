@@ -0,0 +1,136 @@
+#ifndef SYNTACTIC_PIPELINE_H
+#define SYNTACTIC_PIPELINE_H
+
+// 流水线模式：词法分析在单独的线程上运行，每攒满一批单词就放进无锁的单生产者 / 单消费者环形队列，
+// 语法分析线程从队列中按批取单词。队列满时词法分析线程等待（反压），空时语法分析线程等待；
+// 队列的槽和每批的单词数组在开始时分配，之后反复使用，内存与源文件长度无关。
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "lexer.h"
+#include "token.h"
+
+// 单生产者 / 单消费者的无锁环形队列。两端各自缓存对方的下标，只有看起来满 / 空时才读对方的原子变量
+template <class T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t n = 2;
+        while (n < capacity) n *= 2;
+        slots_.resize(n);
+        mask_ = n - 1;
+    }
+
+    // 生产者：下一个可写的槽，队列满时返回 nullptr；写好后调用 push
+    T* back() {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - headCache_ == slots_.size()) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (tail - headCache_ == slots_.size()) return nullptr;
+        }
+        return &slots_[tail & mask_];
+    }
+    void push() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // 消费者：队头的槽，队列空时返回 nullptr；用完后调用 pop
+    T* front() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tailCache_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (head == tailCache_) return nullptr;
+        }
+        return &slots_[head & mask_];
+    }
+    void pop() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+    // 消费者写 head_，生产者写 tail_，分别放在不同的缓存行上
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t tailCache_ = 0; // 消费者使用
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t headCache_ = 0; // 生产者使用
+};
+
+struct TokenBatch {
+    std::vector<Token> tokens;
+    bool last = false; // 最后一批（之后没有单词）
+};
+
+// 在后台线程做词法分析的单词来源，用法与 Lexer 相同
+class PipelinedLexer {
+public:
+    // 每批 batchSize 个单词，队列中最多 queueBatches 批
+    PipelinedLexer(const char* data, size_t size, size_t batchSize, size_t queueBatches)
+        : queue_(queueBatches), batchSize_(batchSize < 1 ? 1 : batchSize) {
+        thread_ = std::thread([this, data, size] { produce(data, size); });
+    }
+
+    PipelinedLexer(const PipelinedLexer&) = delete;
+    PipelinedLexer& operator=(const PipelinedLexer&) = delete;
+
+    ~PipelinedLexer() {
+        stop_.store(true, std::memory_order_relaxed);
+        thread_.join();
+    }
+
+    bool next(Token& tok) {
+        while (true) {
+            if (!batch_) {
+                while (!(batch_ = queue_.front())) {
+                    consumerWaits_++;
+                    std::this_thread::yield();
+                }
+                pos_ = 0;
+            }
+            if (pos_ < batch_->tokens.size()) {
+                tok = batch_->tokens[pos_++];
+                return true;
+            }
+            if (batch_->last) return false;
+            queue_.pop();
+            batch_ = nullptr;
+        }
+    }
+
+    // 等待次数：生产者因队列满等待（反压），消费者因队列空等待
+    size_t producerWaits() const { return producerWaits_.load(std::memory_order_relaxed); }
+    size_t consumerWaits() const { return consumerWaits_; }
+
+private:
+    void produce(const char* data, size_t size) {
+        Lexer lexer(data, size);
+        bool more = true;
+        while (more) {
+            TokenBatch* batch;
+            while (!(batch = queue_.back())) {
+                if (stop_.load(std::memory_order_relaxed)) return;
+                producerWaits_.fetch_add(1, std::memory_order_relaxed);
+                std::this_thread::yield();
+            }
+            batch->tokens.resize(batchSize_);
+            size_t n = 0;
+            while (n < batchSize_ && (more = lexer.next(batch->tokens[n]))) n++;
+            batch->tokens.resize(n);
+            batch->last = !more;
+            queue_.push();
+        }
+    }
+
+    SpscQueue<TokenBatch> queue_;
+    size_t batchSize_;
+    std::thread thread_;
+    std::atomic<bool> stop_{false};
+    std::atomic<size_t> producerWaits_{0};
+    size_t consumerWaits_ = 0;
+    TokenBatch* batch_ = nullptr;
+    size_t pos_ = 0;
+};
+
+#endif
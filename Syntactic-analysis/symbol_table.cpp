@@ -0,0 +1,33 @@
+#include "symbol_table.h"
+
+bool SymbolTable::define(uint32_t id, Symbol symbol) {
+    // 表只在出现新编号时变长，按倍数增长
+    if (id >= entries_.size()) {
+        if (id >= entries_.capacity()) entries_.reserve(id * 2 + 64);
+        entries_.resize(id + 1);
+    }
+    Entry& entry = entries_[id];
+    uint32_t scope = (uint32_t)marks_.size();
+    if (entry.symbol.kind != SymbolKind::None && entry.depth == scope) return false;
+    // 全局作用域的定义不会被撤销，不必记日志
+    if (scope > 0) log_.push_back({id, entry});
+    entry.symbol = symbol;
+    entry.depth = scope;
+    return true;
+}
+
+void SymbolTable::popScope() {
+    if (marks_.empty()) return;
+    size_t mark = marks_.back();
+    marks_.pop_back();
+    while (log_.size() > mark) {
+        entries_[log_.back().id] = log_.back().previous;
+        log_.pop_back();
+    }
+}
+
+void SymbolTable::clear() {
+    entries_.clear();
+    log_.clear();
+    marks_.clear();
+}
@@ -0,0 +1,61 @@
+#ifndef SYNTACTIC_SYMBOL_TABLE_H
+#define SYNTACTIC_SYMBOL_TABLE_H
+
+// 符号表：按标识符的驻留编号（见 interner.h）查常量、变量和函数的定义。
+// 编号从 0 起连续分配，表就是以编号为下标的数组（相当于没有冲突的哈希表），每项是该名字当前可见的定义；
+// 查找只是一次下标访问，不分配内存。
+// 作用域用撤销日志实现：在内层作用域定义名字时把被遮盖的旧定义记入日志，进入作用域只记下日志的长度，
+// 退出作用域时按日志逆序恢复，代价与该作用域中定义的名字数成正比，与表的大小无关。
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "token.h"
+
+enum class SymbolKind : uint8_t {
+    None,     // 未定义
+    Const,    // 常量
+    Var,      // 变量（包括参数）
+    Function, // 函数
+};
+
+struct Symbol {
+    SymbolKind kind = SymbolKind::None;
+    TokenKind type = TokenKind::NONE; // INTTK / CHARTK；函数为返回类型，无返回值时为 VOIDTK
+};
+
+class SymbolTable {
+public:
+    // 在当前作用域中定义 id；同一作用域中已有定义时保留原来的定义，返回 false
+    bool define(uint32_t id, Symbol symbol);
+
+    // id 当前可见的定义，没有时 kind 为 None
+    const Symbol& lookup(uint32_t id) const {
+        static const Symbol none;
+        return id < entries_.size() ? entries_[id].symbol : none;
+    }
+
+    // 进入 / 退出一层作用域，最外层（深度 0）是全局作用域
+    void pushScope() { marks_.push_back(log_.size()); }
+    void popScope();
+    size_t depth() const { return marks_.size(); }
+
+    void clear();
+
+private:
+    struct Entry {
+        Symbol symbol;
+        uint32_t depth = 0; // 定义所在作用域的深度
+    };
+    struct Undo {
+        uint32_t id;
+        Entry previous;
+    };
+
+    std::vector<Entry> entries_; // 下标为编号
+    std::vector<Undo> log_;      // 内层作用域中被遮盖的定义
+    std::vector<size_t> marks_;  // 各层作用域开始时日志的长度
+};
+
+#endif
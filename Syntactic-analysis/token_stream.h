@@ -0,0 +1,77 @@
+#ifndef SYNTACTIC_TOKEN_STREAM_H
+#define SYNTACTIC_TOKEN_STREAM_H
+
+// 语法分析的单词流：按需从单词来源（词法分析器，或流水线模式下的单词队列）取单词，放在固定大小的环形缓冲区里供预读。
+// 单词在被语法分析"接受"（consume）时才输出，预读的单词不会提前输出；
+// 整个分析过程只保存最多 LOOKAHEAD 个单词，内存与源文件长度无关。
+// 给出标识符表（internIdentifiers）时，标识符在取出时驻留一次，语法分析用 symbol() 取它的编号。
+
+#include <cstddef>
+#include <cstdint>
+
+#include "interner.h"
+#include "source_io.h"
+#include "token.h"
+
+class TokenStream {
+public:
+    // 最多预读的单词数（文法最多需要看 3 个单词：类型 标识符 '('），取 2 的幂便于取模
+    static const size_t LOOKAHEAD = 4;
+
+    // source 为有 bool next(Token&) 的单词来源（如 Lexer），取完时返回 false
+    template <class Source>
+    TokenStream(Source& source, OutputBuffer& out)
+        : source_(&source), next_([](void* s, Token& tok) { return static_cast<Source*>(s)->next(tok); }), out_(out) {}
+
+    // 第 k 个未接受的单词（k < LOOKAHEAD），文件结束后为 NONE
+    const Token& peek(size_t k = 0) {
+        while (count_ <= k) fill();
+        return ring_[(head_ + k) & (LOOKAHEAD - 1)];
+    }
+
+    TokenKind kind(size_t k = 0) { return peek(k).kind; }
+
+    bool at(TokenKind kind, size_t k = 0) { return peek(k).kind == kind; }
+
+    // 此后取出的标识符驻留到 names 中（应在第一次 peek 之前设置）
+    void internIdentifiers(Interner* names) { names_ = names; }
+
+    // 第 k 个未接受的单词是标识符时为它的编号，否则为 Interner::NONE
+    uint32_t symbol(size_t k = 0) {
+        peek(k);
+        return symbols_[(head_ + k) & (LOOKAHEAD - 1)];
+    }
+
+    // 接受当前单词并输出：类别码 单词内容
+    void consume() {
+        const Token& tok = peek();
+        if (tok.kind != TokenKind::NONE) {
+            out_.write(tokenName(tok.kind));
+            out_.put(' ');
+            out_.write(tok.text);
+            out_.put('\n');
+        }
+        head_ = (head_ + 1) & (LOOKAHEAD - 1);
+        count_--;
+    }
+
+private:
+    void fill() {
+        size_t i = (head_ + count_) & (LOOKAHEAD - 1);
+        Token& slot = ring_[i];
+        if (!next_(source_, slot)) slot = Token();
+        symbols_[i] = names_ && slot.kind == TokenKind::IDENFR ? names_->intern(slot.text) : Interner::NONE;
+        count_++;
+    }
+
+    void* source_;
+    bool (*next_)(void* source, Token& tok);
+    OutputBuffer& out_;
+    Interner* names_ = nullptr;
+    Token ring_[LOOKAHEAD];
+    uint32_t symbols_[LOOKAHEAD];
+    size_t head_ = 0;
+    size_t count_ = 0;
+};
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef AUTOMATA_AUTOMATA_H
+#define AUTOMATA_AUTOMATA_H
+
+// 各实验共用的自动机库：正规式 → NFA → DFA → 最小DFA → 识别。
+// 各阶段之间传递的都是 AutomatonData（整数编号的状态 + CSR 边表，见 automaton_format.h），
+// 不经过文本的输出和解析。NFA / NFA-DFA / DFA-Minimization / DFA-Recognition 的 main.cpp
+// 只负责读写评测要求的文本格式、解析参数，再调用这里的接口。
+//
+// 状态命名沿用评测的约定：初态 X，终态 Y（多个终态时 Y, Y1, Y2 ...），其余状态用数字。
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "automaton_format.h"
+
+namespace automata {
+
+// ---------------- 正规式 → NFA / DFA（regex.cpp） ----------------
+
+enum class NFAConstruction {
+    Thompson,    // Thompson 构造，中间状态按片段的结构顺序编号（与评测样例一致）
+    ThompsonBFS, // Thompson 构造，中间状态按 BFS 发现顺序编号（教材写法）
+    Glushkov     // 位置自动机，除正规式可空时 X 到终态的一条空边外没有空边（正规式中的 ~ 不占状态）；终态命名为 Y, Y1 ...
+};
+
+// 由正规式（运算符 | * ( )，连接省略不写）构造NFA，状态按输出顺序排列：X、终态、数字状态。
+// 正规式不合法时返回 false，error 为原因
+bool buildNFA(const std::string& regex, NFAConstruction method, AutomatonData& nfa, std::string& error);
+
+// 由 followpos 直接构造DFA（龙书的方法），命名和状态顺序与 determinize 的结果相同
+bool buildDFADirect(const std::string& regex, AutomatonData& dfa, std::string& error);
+
+// ---------------- 子集构造（determinize.cpp） ----------------
+
+struct DeterminizeOptions {
+    bool parallel = false;  // 多线程子集构造，结果与串行版本相同
+    unsigned threads = 0;   // 线程数，0 表示使用全部核心
+};
+
+// move 缓存（move 的结果 -> DFA状态）的命中 / 未命中次数；命中时不再求闭包、查子集表
+struct DeterminizeStats {
+    size_t moveCacheHits = 0;
+    size_t moveCacheMisses = 0;
+};
+
+// 子集构造。DFA状态按 BFS 发现顺序（字母表升序）编号，初态 X，终态 Y, Y1 ...，其余 0, 1, 2 ...；
+// 结果按 X、Y...、数字 的顺序排列，设置 FLAG_DETERMINISTIC
+AutomatonData determinize(const AutomatonData& nfa, const DeterminizeOptions& options = DeterminizeOptions(),
+                          DeterminizeStats* stats = nullptr);
+
+// 状态标记：给终态附加的非负整数（例如词法分析中终态对应的单词种类），数值越小越优先
+const uint32_t NO_TAG = 0xFFFFFFFFu;
+
+// 带标记的子集构造：nfaTags[s] 为NFA状态 s 的标记，dfaTags 按结果的状态顺序给出
+// 每个DFA状态所含NFA状态标记的最小值（都没有标记时为 NO_TAG）。结果与不带标记的版本相同
+AutomatonData determinize(const AutomatonData& nfa, const std::vector<uint32_t>& nfaTags,
+                          std::vector<uint32_t>& dfaTags, const DeterminizeOptions& options = DeterminizeOptions(),
+                          DeterminizeStats* stats = nullptr);
+
+// 惰性DFA：不做完全确定化，DFA状态只在匹配时第一次走到才构造，放在有内存上限的缓存中；
+// 缓存抖动时退回直接模拟NFA
+struct LazyDFAStats {
+    size_t statesBuilt = 0;
+    size_t cached = 0;
+    size_t cacheHits = 0;
+    size_t flushes = 0;
+    bool fellBackToNFA = false;
+};
+
+class LazyDFA {
+public:
+    LazyDFA(const AutomatonData& nfa, size_t budgetBytes);
+    ~LazyDFA();
+    LazyDFA(const LazyDFA&) = delete;
+    LazyDFA& operator=(const LazyDFA&) = delete;
+
+    bool match(const char* s, size_t len);
+    LazyDFAStats stats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// ---------------- DFA 最小化（minimize.cpp） ----------------
+
+// Hopcroft 算法。缺失的转移视为到达一个隐含的死状态；
+// 每组的代表：含 X 取 X，否则含 Y 取 Y，否则取字典序最小的状态名。
+// 结果按 X、Y、数字 的顺序排列，设置 FLAG_DETERMINISTIC
+AutomatonData minimize(const AutomatonData& dfa);
+
+// 带标记的最小化：只合并标记相同的状态，resultTags 按结果的状态顺序给出各状态的标记
+AutomatonData minimize(const AutomatonData& dfa, const std::vector<uint32_t>& tags, std::vector<uint32_t>& resultTags);
+
+// ---------------- 识别（match.cpp） ----------------
+
+// 稠密转移表：识别时每读一个字节只需一次下标访问 table[state * 256 + c]
+const uint32_t DEAD_STATE = 0xFFFFFFFFu;
+
+struct DenseDFA {
+    std::vector<uint32_t> table;    // states × 256，缺失的转移为 DEAD_STATE
+    std::vector<uint8_t> accepting; // accepting[id] != 0 表示终态
+    uint32_t start = DEAD_STATE;
+};
+
+// 状态编号沿用 dfa 中的编号；空自动机得到一个不接受任何串的状态。
+// 读二进制文件时可以直接由映射的 AutomatonView 建表，不必先复制成 AutomatonData
+DenseDFA buildDenseDFA(const AutomatonData& dfa);
+DenseDFA buildDenseDFA(const AutomatonView& dfa);
+
+// 识别一个串。consumed 不为空时给出成功转移的字符数（出错时即出错的位置）
+bool match(const DenseDFA& dfa, const char* s, size_t len, size_t* consumed = nullptr);
+
+// 多路交错识别：若干个互不相关的串放在不同的"路"里同时推进，隐藏查表的访存延迟
+struct Span {
+    const char* s;
+    size_t len;
+};
+
+enum class MatchKernel {
+    Scalar8,  // 8 路标量
+    Scalar16, // 16 路标量
+    AVX2      // 8 路 AVX2 gather，CPU 不支持或状态数达到 2^23 时退回 16 路标量
+};
+
+// verdicts[i] = 1 表示 inputs[i] 被接受
+void matchMany(const DenseDFA& dfa, const std::vector<Span>& inputs, std::vector<uint8_t>& verdicts,
+               MatchKernel kernel = MatchKernel::Scalar16);
+
+bool cpuHasAVX2();
+
+} // namespace automata
+
+#endif // AUTOMATA_AUTOMATA_H
@@ -0,0 +1,452 @@
+#ifndef AUTOMATA_AUTOMATON_FORMAT_H
+#define AUTOMATA_AUTOMATON_FORMAT_H
+
+// 自动机的二进制格式，NFA / NFA-DFA / DFA-Minimization / DFA-Recognition 共用。
+//
+// 文件布局（小端，各段按 8 字节对齐，偏移都从文件开头算起）：
+//   FileHeader
+//   nameOffsets  uint32[stateCount + 1]   状态名在 names 中的起止位置
+//   names        char[nameBytes]          所有状态名首尾相接
+//   edgeOffsets  uint32[stateCount + 1]   CSR：状态 s 的边为 [edgeOffsets[s], edgeOffsets[s + 1])
+//   edgeTargets  uint32[edgeCount]
+//   edgeSymbols  uint8[edgeCount]         字母表下标，EPSILON_SYMBOL 表示空串 '~'
+//   alphabet     uint8[alphabetSize]      下标 -> 实际字符
+//   accepting    uint64[(stateCount + 63) / 64]  终态位图
+//
+// 读取时把文件映射进内存，AutomatonView 直接指向映射区，不做任何解析和拷贝。
+// 与现有文本格式（X X-a->0 X-b->1）之间的互相转换见 parseAutomatonText / formatAutomatonText。
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <istream>
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace automata {
+
+const uint32_t FORMAT_MAGIC = 0x31414657u; // "WFA1"
+const uint16_t FORMAT_VERSION = 1;
+const uint8_t EPSILON_SYMBOL = 0xFF;
+const char EPSILON_CHAR = '~';
+
+// flags
+const uint16_t FLAG_DETERMINISTIC = 1;
+
+struct FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t stateCount;
+    uint32_t edgeCount;
+    uint32_t alphabetSize;
+    uint32_t startState;
+    uint32_t nameBytes;
+    uint32_t reserved;
+    uint64_t nameOffsetsPos;
+    uint64_t namesPos;
+    uint64_t edgeOffsetsPos;
+    uint64_t edgeTargetsPos;
+    uint64_t edgeSymbolsPos;
+    uint64_t alphabetPos;
+    uint64_t acceptingPos;
+    uint64_t fileSize;
+};
+
+// 可修改的内存形式：各阶段之间传递的自动机（状态为 0..stateCount-1 的整数编号），也用于构造后写出。
+// 布局与二进制格式相同，访问接口与 AutomatonView 相同
+struct AutomatonData {
+    std::vector<std::string> names;
+    std::vector<uint32_t> edgeOffsets{0};
+    std::vector<uint32_t> edgeTargets;
+    std::vector<uint8_t> edgeSymbols;
+    std::vector<char> alphabet;
+    std::vector<uint64_t> accepting;
+    uint32_t startState = 0;
+    uint16_t flags = 0;
+
+    uint32_t stateCount() const { return (uint32_t)names.size(); }
+    uint32_t edgeCount() const { return (uint32_t)edgeTargets.size(); }
+    const std::string& name(uint32_t s) const { return names[s]; }
+    bool isAccepting(uint32_t s) const { return (accepting[s >> 6] >> (s & 63)) & 1; }
+    void setAccepting(uint32_t s, bool value) {
+        if (value) accepting[s >> 6] |= 1ull << (s & 63);
+        else accepting[s >> 6] &= ~(1ull << (s & 63));
+    }
+    // 边 e 上的字符，空串返回 '~'
+    char symbol(uint32_t e) const {
+        return edgeSymbols[e] == EPSILON_SYMBOL ? EPSILON_CHAR : alphabet[edgeSymbols[e]];
+    }
+
+    // 依次添加状态：先 addState，再为它 addEdge，直到下一个 addState
+    uint32_t addState(const std::string& name, bool isAccepting) {
+        uint32_t id = (uint32_t)names.size();
+        names.push_back(name);
+        edgeOffsets.push_back(edgeOffsets.back());
+        if (accepting.size() * 64 < names.size()) accepting.push_back(0);
+        if (isAccepting) accepting[id >> 6] |= 1ull << (id & 63);
+        return id;
+    }
+
+    // 为最后添加的状态加一条边，c 为 '~' 时表示空串
+    void addEdge(char c, uint32_t to) {
+        edgeTargets.push_back(to);
+        edgeSymbols.push_back(symbolIndex(c));
+        edgeOffsets.back()++;
+    }
+
+    uint8_t symbolIndex(char c) {
+        if (c == EPSILON_CHAR) return EPSILON_SYMBOL;
+        for (size_t i = 0; i < alphabet.size(); i++) {
+            if (alphabet[i] == c) return (uint8_t)i;
+        }
+        alphabet.push_back(c);
+        return (uint8_t)(alphabet.size() - 1);
+    }
+
+    // 按名字查找状态，不存在返回 -1
+    int64_t findState(const std::string& name) const {
+        for (size_t s = 0; s < names.size(); s++) {
+            if (names[s] == name) return (int64_t)s;
+        }
+        return -1;
+    }
+};
+
+// 只读视图：各数组直接指向映射的文件内容
+struct AutomatonView {
+    const FileHeader* header = nullptr;
+    const uint32_t* nameOffsets = nullptr;
+    const char* names = nullptr;
+    const uint32_t* edgeOffsets = nullptr;
+    const uint32_t* edgeTargets = nullptr;
+    const uint8_t* edgeSymbols = nullptr;
+    const char* alphabet = nullptr;
+    const uint64_t* accepting = nullptr;
+
+    uint32_t stateCount() const { return header->stateCount; }
+    uint32_t edgeCount() const { return header->edgeCount; }
+    uint32_t alphabetSize() const { return header->alphabetSize; }
+    uint32_t startState() const { return header->startState; }
+
+    std::string name(uint32_t s) const {
+        return std::string(names + nameOffsets[s], nameOffsets[s + 1] - nameOffsets[s]);
+    }
+    bool isAccepting(uint32_t s) const { return (accepting[s >> 6] >> (s & 63)) & 1; }
+    // 边 e 上的字符，空串返回 '~'
+    char symbol(uint32_t e) const {
+        return edgeSymbols[e] == EPSILON_SYMBOL ? EPSILON_CHAR : alphabet[edgeSymbols[e]];
+    }
+};
+
+// 把映射的文件复制成可修改的内存形式（布局相同，各数组整段复制）
+inline AutomatonData toAutomatonData(const AutomatonView& view) {
+    AutomatonData data;
+    uint32_t states = view.stateCount(), edges = view.edgeCount();
+    data.names.reserve(states);
+    for (uint32_t s = 0; s < states; s++) data.names.push_back(view.name(s));
+    data.edgeOffsets.assign(view.edgeOffsets, view.edgeOffsets + (size_t)states + 1);
+    data.edgeTargets.assign(view.edgeTargets, view.edgeTargets + edges);
+    data.edgeSymbols.assign(view.edgeSymbols, view.edgeSymbols + edges);
+    data.alphabet.assign(view.alphabet, view.alphabet + view.alphabetSize());
+    data.accepting.assign(view.accepting, view.accepting + ((size_t)states + 63) / 64);
+    data.startState = states > 0 ? view.startState() : 0;
+    data.flags = view.header->flags;
+    return data;
+}
+
+inline uint64_t alignTo8(uint64_t x) { return (x + 7) & ~(uint64_t)7; }
+
+// 计算各段位置；各段长度按 64 位计算，计数取到 0xFFFFFFFF 也不会回绕
+inline FileHeader layoutHeader(uint32_t states, uint32_t edges, uint32_t alphabetSize, uint32_t nameBytes) {
+    FileHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = FORMAT_MAGIC;
+    h.version = FORMAT_VERSION;
+    h.stateCount = states;
+    h.edgeCount = edges;
+    h.alphabetSize = alphabetSize;
+    h.nameBytes = nameBytes;
+    uint64_t pos = alignTo8(sizeof(FileHeader));
+    h.nameOffsetsPos = pos;
+    pos = alignTo8(pos + 4ull * ((uint64_t)states + 1));
+    h.namesPos = pos;
+    pos = alignTo8(pos + nameBytes);
+    h.edgeOffsetsPos = pos;
+    pos = alignTo8(pos + 4ull * ((uint64_t)states + 1));
+    h.edgeTargetsPos = pos;
+    pos = alignTo8(pos + 4ull * edges);
+    h.edgeSymbolsPos = pos;
+    pos = alignTo8(pos + edges);
+    h.alphabetPos = pos;
+    pos = alignTo8(pos + alphabetSize);
+    h.acceptingPos = pos;
+    pos += 8ull * (((uint64_t)states + 63) / 64);
+    h.fileSize = pos;
+    return h;
+}
+
+// 把 data 写成二进制格式，失败返回 false
+inline bool writeAutomaton(const char* path, const AutomatonData& data) {
+    uint32_t states = data.stateCount();
+    std::vector<uint32_t> nameOffsets(1, 0);
+    std::string names;
+    for (const auto& n : data.names) {
+        names += n;
+        nameOffsets.push_back((uint32_t)names.size());
+    }
+    FileHeader h = layoutHeader(states, (uint32_t)data.edgeTargets.size(), (uint32_t)data.alphabet.size(),
+                                (uint32_t)names.size());
+    h.startState = data.startState;
+    h.flags = data.flags;
+
+    std::vector<char> buf((size_t)h.fileSize, 0);
+    memcpy(buf.data(), &h, sizeof(h));
+    memcpy(buf.data() + h.nameOffsetsPos, nameOffsets.data(), 4 * nameOffsets.size());
+    if (!names.empty()) memcpy(buf.data() + h.namesPos, names.data(), names.size());
+    memcpy(buf.data() + h.edgeOffsetsPos, data.edgeOffsets.data(), 4 * ((size_t)states + 1));
+    if (h.edgeCount) {
+        memcpy(buf.data() + h.edgeTargetsPos, data.edgeTargets.data(), 4 * h.edgeCount);
+        memcpy(buf.data() + h.edgeSymbolsPos, data.edgeSymbols.data(), h.edgeCount);
+    }
+    if (h.alphabetSize) memcpy(buf.data() + h.alphabetPos, data.alphabet.data(), h.alphabetSize);
+    std::vector<uint64_t> accepting(data.accepting);
+    accepting.resize(((size_t)states + 63) / 64, 0);
+    if (!accepting.empty()) memcpy(buf.data() + h.acceptingPos, accepting.data(), 8 * accepting.size());
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+    return fclose(f) == 0 && ok;
+}
+
+// 映射一个二进制自动机文件；不支持 mmap 时整体读入
+class MappedAutomaton {
+public:
+    MappedAutomaton() {}
+    MappedAutomaton(const MappedAutomaton&) = delete;
+    MappedAutomaton& operator=(const MappedAutomaton&) = delete;
+    ~MappedAutomaton() { close(); }
+
+    // 打开并校验文件，失败时返回 false 并在 error 中给出原因
+    bool open(const char* path, std::string& error) {
+        close();
+        if (!mapFile(path)) {
+            error = std::string("无法打开文件 ") + path;
+            return false;
+        }
+        if (size_ < sizeof(FileHeader)) {
+            error = "文件过短";
+            return false;
+        }
+        const FileHeader* h = (const FileHeader*)data_;
+        if (h->magic != FORMAT_MAGIC) {
+            error = "不是自动机二进制文件";
+            return false;
+        }
+        if (h->version != FORMAT_VERSION) {
+            error = "不支持的格式版本 " + std::to_string(h->version);
+            return false;
+        }
+        // 先按计数估计各段至少要占的字节数，放不进文件的计数直接拒绝
+        uint64_t minBytes = sizeof(FileHeader) + 8ull * ((uint64_t)h->stateCount + 1) + 5ull * h->edgeCount +
+                            h->nameBytes + h->alphabetSize + 8ull * (((uint64_t)h->stateCount + 63) / 64);
+        if (minBytes > size_) {
+            error = "文件内容不完整";
+            return false;
+        }
+        // 各段的位置由计数唯一确定，逐一核对，避免按被篡改的偏移访问映射区之外
+        FileHeader expect = layoutHeader(h->stateCount, h->edgeCount, h->alphabetSize, h->nameBytes);
+        if (h->fileSize != expect.fileSize || size_ < h->fileSize || h->nameOffsetsPos != expect.nameOffsetsPos ||
+            h->namesPos != expect.namesPos || h->edgeOffsetsPos != expect.edgeOffsetsPos ||
+            h->edgeTargetsPos != expect.edgeTargetsPos || h->edgeSymbolsPos != expect.edgeSymbolsPos ||
+            h->alphabetPos != expect.alphabetPos || h->acceptingPos != expect.acceptingPos) {
+            error = "文件内容不完整";
+            return false;
+        }
+        view_.header = h;
+        view_.nameOffsets = (const uint32_t*)(data_ + h->nameOffsetsPos);
+        view_.names = data_ + h->namesPos;
+        view_.edgeOffsets = (const uint32_t*)(data_ + h->edgeOffsetsPos);
+        view_.edgeTargets = (const uint32_t*)(data_ + h->edgeTargetsPos);
+        view_.edgeSymbols = (const uint8_t*)(data_ + h->edgeSymbolsPos);
+        view_.alphabet = data_ + h->alphabetPos;
+        view_.accepting = (const uint64_t*)(data_ + h->acceptingPos);
+        if (!validate(error)) {
+            view_ = AutomatonView();
+            return false;
+        }
+        return true;
+    }
+
+    const AutomatonView& view() const { return view_; }
+
+private:
+    // 检查各数组的内容：偏移单调且与计数一致、边的目标和字符在范围内、初态存在。
+    // 通过后按视图访问不会越界；只读一遍，不做拷贝
+    bool validate(std::string& error) const {
+        const AutomatonView& v = view_;
+        uint32_t states = v.stateCount(), edges = v.edgeCount();
+        if (states > 0 && v.startState() >= states) {
+            error = "初态编号超出范围";
+            return false;
+        }
+        if (v.nameOffsets[0] != 0 || v.nameOffsets[states] != v.header->nameBytes || v.edgeOffsets[0] != 0 ||
+            v.edgeOffsets[states] != edges) {
+            error = "状态名或边的偏移表不完整";
+            return false;
+        }
+        for (uint32_t s = 0; s < states; s++) {
+            if (v.nameOffsets[s] > v.nameOffsets[s + 1] || v.edgeOffsets[s] > v.edgeOffsets[s + 1]) {
+                error = "状态名或边的偏移表不是递增的";
+                return false;
+            }
+        }
+        for (uint32_t e = 0; e < edges; e++) {
+            if (v.edgeTargets[e] >= states) {
+                error = "边的目标状态超出范围";
+                return false;
+            }
+            if (v.edgeSymbols[e] >= v.alphabetSize() && v.edgeSymbols[e] != EPSILON_SYMBOL) {
+                error = "边上的字符超出字母表";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool mapFile(const char* path) {
+#ifndef _WIN32
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (p == MAP_FAILED) return false;
+            mapped_ = p;
+            data_ = (const char*)p;
+            size_ = (size_t)st.st_size;
+            return true;
+        }
+        ::close(fd);
+#endif
+        // 读入的缓冲区按 8 字节对齐，保证各段可以直接按数组访问
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return false;
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        buffer_.assign((bytes.size() + 7) / 8, 0);
+        if (!bytes.empty()) memcpy(buffer_.data(), bytes.data(), bytes.size());
+        data_ = (const char*)buffer_.data();
+        size_ = bytes.size();
+        return true;
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (mapped_) munmap(mapped_, size_);
+#endif
+        mapped_ = nullptr;
+        data_ = nullptr;
+        size_ = 0;
+        buffer_.clear();
+        view_ = AutomatonView();
+    }
+
+    void* mapped_ = nullptr;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<uint64_t> buffer_;
+    AutomatonView view_;
+};
+
+// ---------------- 与文本格式互相转换 ----------------
+
+// 读入文本格式（每行 "状态 状态-字符->目标 ..."，遇到空行或文件结束为止）。
+// 各行的源状态按行序编号，只作为目标出现的状态排在后面；
+// 名字中含 'Y' 的状态为终态，X 为初态
+inline AutomatonData parseAutomatonText(std::istream& in) {
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> ids;
+    auto intern = [&](const std::string& n) {
+        auto it = ids.find(n);
+        if (it != ids.end()) return it->second;
+        uint32_t id = (uint32_t)names.size();
+        ids[n] = id;
+        names.push_back(n);
+        return id;
+    };
+
+    std::vector<uint32_t> lineState;
+    std::vector<std::vector<std::pair<char, std::string>>> lineEdges;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) break;
+        std::stringstream ss(line);
+        std::string src, token;
+        if (!(ss >> src)) continue;
+        lineState.push_back(intern(src));
+        lineEdges.push_back({});
+        while (ss >> token) {
+            size_t dash = token.find('-');
+            size_t arrow = token.find("->");
+            if (dash == std::string::npos || arrow == std::string::npos) continue;
+            lineEdges.back().push_back({token[dash + 1], token.substr(arrow + 2)});
+        }
+    }
+
+    // 同一状态可能出现在多行，边按行序合并
+    std::vector<std::vector<std::pair<char, uint32_t>>> edges(names.size());
+    for (size_t i = 0; i < lineState.size(); i++) {
+        for (const auto& e : lineEdges[i]) {
+            uint32_t to = intern(e.second);
+            edges.resize(names.size());
+            edges[lineState[i]].push_back({e.first, to});
+        }
+    }
+
+    AutomatonData data;
+    for (size_t s = 0; s < names.size(); s++) {
+        data.addState(names[s], names[s].find('Y') != std::string::npos);
+        for (const auto& e : edges[s]) data.addEdge(e.first, e.second);
+        if (names[s] == "X") data.startState = (uint32_t)s;
+    }
+    return data;
+}
+
+// 输出文本格式：每个状态一行，按状态编号顺序。view 可以是 AutomatonView 或 AutomatonData
+template <class View>
+std::string formatAutomatonText(const View& view) {
+    std::string out;
+    for (uint32_t s = 0; s < view.stateCount(); s++) {
+        std::string name = view.name(s);
+        out += name;
+        for (uint32_t e = view.edgeOffsets[s]; e < view.edgeOffsets[s + 1]; e++) {
+            out += ' ';
+            out += name;
+            out += '-';
+            out += view.symbol(e);
+            out += "->";
+            out += view.name(view.edgeTargets[e]);
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+} // namespace automata
+
+#endif // AUTOMATA_AUTOMATON_FORMAT_H
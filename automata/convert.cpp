@@ -0,0 +1,41 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+
+#include "automaton_format.h"
+
+using namespace std;
+
+// 自动机 文本格式 <-> 二进制格式 转换工具
+//   fa_convert to-bin <输出文件>   从标准输入读文本格式，写出二进制文件
+//   fa_convert to-text <输入文件>  读二进制文件，向标准输出写文本格式
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        cerr << "用法: fa_convert to-bin <输出文件> < 文本" << endl;
+        cerr << "      fa_convert to-text <输入文件>" << endl;
+        return 1;
+    }
+
+    if (strcmp(argv[1], "to-bin") == 0) {
+        automata::AutomatonData data = automata::parseAutomatonText(cin);
+        if (!automata::writeAutomaton(argv[2], data)) {
+            cerr << "无法写入文件 " << argv[2] << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (strcmp(argv[1], "to-text") == 0) {
+        automata::MappedAutomaton file;
+        string error;
+        if (!file.open(argv[2], error)) {
+            cerr << error << endl;
+            return 1;
+        }
+        cout << automata::formatAutomatonText(file.view());
+        return 0;
+    }
+
+    cerr << "未知的命令 " << argv[1] << endl;
+    return 1;
+}
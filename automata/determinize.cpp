@@ -0,0 +1,818 @@
+// 子集构造（串行 / 并行）与惰性DFA
+
+#include "automata.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace automata {
+
+namespace {
+
+// 最低位 1 的下标（x 非 0）
+inline int lowestBit(uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return (int)i;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// NFA状态集合：按状态编号存放的位集，hash 在集合确定后计算一次
+struct StateSet {
+    std::vector<uint64_t> bits;
+    uint64_t hash = 0;
+
+    StateSet() {}
+    explicit StateSet(size_t n) : bits((n + 63) / 64, 0) {}
+
+    void insert(int s) { bits[s >> 6] |= 1ull << (s & 63); }
+    bool count(int s) const { return (bits[s >> 6] >> (s & 63)) & 1; }
+    bool empty() const {
+        for (uint64_t w : bits) if (w) return false;
+        return true;
+    }
+    // 按编号从小到大遍历集合中的状态
+    template <class F>
+    void forEach(F f) const {
+        for (size_t i = 0; i < bits.size(); i++) {
+            uint64_t w = bits[i];
+            while (w) {
+                f((int)(i * 64 + lowestBit(w)));
+                w &= w - 1;
+            }
+        }
+    }
+    void computeHash() {
+        uint64_t h = 0x9E3779B97F4A7C15ull;
+        for (uint64_t w : bits) {
+            h ^= w + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+            h *= 0xBF58476D1CE4E5B9ull;
+        }
+        hash = h ^ (h >> 31);
+    }
+};
+
+// 子集 -> DFA状态编号 的开放寻址哈希表（线性探测）
+// 子集本身统一存放在 pool 中，第 i 个DFA状态占 pool[i * words, (i + 1) * words)
+struct SubsetTable {
+    size_t words = 0;
+    std::vector<uint64_t> pool;
+    std::vector<uint64_t> hashes;
+    std::vector<int> slots; // -1 表示空槽
+    size_t mask = 0;
+
+    explicit SubsetTable(size_t w) : words(w), slots(1024, -1), mask(1023) {}
+
+    int size() const { return (int)hashes.size(); }
+
+    const uint64_t* subset(int id) const { return pool.data() + (size_t)id * words; }
+
+    bool equals(int id, const StateSet& s) const {
+        const uint64_t* p = subset(id);
+        for (size_t i = 0; i < words; i++) if (p[i] != s.bits[i]) return false;
+        return true;
+    }
+
+    // 查找子集，不存在返回 -1
+    int find(const StateSet& s) const {
+        for (size_t i = s.hash & mask;; i = (i + 1) & mask) {
+            int id = slots[i];
+            if (id < 0) return -1;
+            if (hashes[id] == s.hash && equals(id, s)) return id;
+        }
+    }
+
+    // 插入一个新子集（调用前已确认不存在），返回其编号
+    int insert(const StateSet& s) {
+        if ((hashes.size() + 1) * 2 > slots.size()) grow();
+        int id = size();
+        pool.insert(pool.end(), s.bits.begin(), s.bits.end());
+        hashes.push_back(s.hash);
+        place(id);
+        return id;
+    }
+
+    void clear() {
+        pool.clear();
+        hashes.clear();
+        std::fill(slots.begin(), slots.end(), -1);
+    }
+
+    StateSet get(int id) const {
+        StateSet s;
+        s.bits.assign(subset(id), subset(id) + words);
+        s.hash = hashes[id];
+        return s;
+    }
+
+private:
+    void place(int id) {
+        size_t i = hashes[id] & mask;
+        while (slots[i] >= 0) i = (i + 1) & mask;
+        slots[i] = id;
+    }
+
+    void grow() {
+        slots.assign(slots.size() * 2, -1);
+        mask = slots.size() - 1;
+        for (int id = 0; id < size(); id++) place(id);
+    }
+};
+
+// 子集构造所需的NFA：边表、终态位集、字母表、状态标记，以及预先算好的 epsilon 闭包。
+// 构造完成后只读，可以被多个线程同时使用
+class NFAGraph {
+public:
+    explicit NFAGraph(const AutomatonData& nfa, const std::vector<uint32_t>* tags = nullptr)
+        : n_(nfa.stateCount()), offsets_(nfa.edgeOffsets), targets_(nfa.edgeTargets), finals_(nfa.stateCount()) {
+        if (tags) tags_ = *tags;
+        chars_.resize(nfa.edgeCount());
+        bool seen[256] = {false};
+        for (uint32_t e = 0; e < nfa.edgeCount(); e++) {
+            chars_[e] = nfa.symbol(e);
+            if (chars_[e] != EPSILON_CHAR) seen[(unsigned char)chars_[e]] = true;
+        }
+        // 字母表按字符升序（与 set<char> 的顺序相同），不包含 '~'
+        for (int c = -128; c < 128; c++) {
+            if (seen[(unsigned char)(char)c]) alphabet_.push_back((char)c);
+        }
+        for (uint32_t s = 0; s < nfa.stateCount(); s++) {
+            if (nfa.isAccepting(s)) finals_.insert((int)s);
+        }
+        start_ = (int)nfa.startState;
+        buildEpsilonClosures();
+    }
+
+    size_t size() const { return n_; }
+    size_t words() const { return (n_ + 63) / 64; }
+    const std::vector<char>& alphabet() const { return alphabet_; }
+
+    // 初态的闭包
+    StateSet startSet() const {
+        StateSet init(n_);
+        init.insert(start_);
+        return closure(init);
+    }
+
+    // 获取一个集合的epsilon闭包：把各状态预先算好的闭包按位或起来
+    StateSet closure(const StateSet& states) const {
+        StateSet result(n_);
+        if (closureTableEnabled_) {
+            states.forEach([&](int s) {
+                const uint64_t* c = closurePool_.data() + (size_t)closureIndex_[s] * closureWords_;
+                for (size_t i = 0; i < closureWords_; i++) result.bits[i] |= c[i];
+            });
+        } else {
+            // 未建表时用显式栈遍历，result 充当 visited 集合
+            std::vector<int> pending;
+            states.forEach([&](int s) {
+                if (result.count(s)) return;
+                result.insert(s);
+                pending.push_back(s);
+                while (!pending.empty()) {
+                    int v = pending.back();
+                    pending.pop_back();
+                    for (uint32_t e = offsets_[v]; e < offsets_[v + 1]; e++) {
+                        int to = (int)targets_[e];
+                        if (chars_[e] == EPSILON_CHAR && !result.count(to)) {
+                            result.insert(to);
+                            pending.push_back(to);
+                        }
+                    }
+                }
+            });
+        }
+        result.computeHash();
+        return result;
+    }
+
+    // Move操作：从状态集合states经过字符val能到达的NFA状态集合
+    StateSet moveSet(const StateSet& states, char val) const {
+        StateSet result(n_);
+        states.forEach([&](int s) {
+            for (uint32_t e = offsets_[s]; e < offsets_[s + 1]; e++) {
+                if (chars_[e] == val) result.insert((int)targets_[e]);
+            }
+        });
+        return result;
+    }
+
+    // 检查集合中是否包含NFA的终态
+    bool isFinalSet(const StateSet& states) const {
+        for (size_t i = 0; i < states.bits.size(); i++) {
+            if (states.bits[i] & finals_.bits[i]) return true;
+        }
+        return false;
+    }
+
+    // 集合的标记：所含NFA状态标记的最小值，没有标记时为 NO_TAG
+    uint32_t tagOf(const StateSet& states) const {
+        uint32_t tag = NO_TAG;
+        if (tags_.empty()) return tag;
+        states.forEach([&](int s) { tag = std::min(tag, tags_[s]); });
+        return tag;
+    }
+
+private:
+    // 每个NFA状态的epsilon闭包 (包含自身)，预处理时计算一次。
+    // 同一个epsilon强连通分量内的状态闭包相同，所以按分量存放：
+    // 状态 s 的闭包位于 closurePool_[closureIndex_[s] * 字数, ...)
+    // 闭包表的大小最坏是 状态数^2 位，超过 CLOSURE_TABLE_BUDGET 字节时不建表，
+    // 改为每次用显式栈遍历epsilon边
+    static const size_t CLOSURE_TABLE_BUDGET = (size_t)512 << 20;
+
+    // 在epsilon边构成的图上用迭代版 Tarjan 算法求强连通分量。
+    // Tarjan 按逆拓扑序产出分量（后继分量先完成），
+    // 因此每个分量完成时，其后继分量的闭包都已算好，直接按位或即可
+    void buildEpsilonClosures() {
+        const int n = (int)n_;
+        closureWords_ = words();
+        closureTableEnabled_ = n_ * closureWords_ * sizeof(uint64_t) <= CLOSURE_TABLE_BUDGET;
+        if (!closureTableEnabled_) return;
+        closureIndex_.assign(n, -1);
+        closurePool_.clear();
+
+        std::vector<int> index(n, -1), low(n, 0);
+        std::vector<char> onStack(n, 0);
+        std::vector<int> sccStack;
+        // 显式调用栈：(状态, 下一条待检查的边)
+        std::vector<std::pair<int, uint32_t>> callStack;
+        int counter = 0;
+
+        for (int root = 0; root < n; root++) {
+            if (index[root] >= 0) continue;
+            callStack.push_back({root, offsets_[root]});
+            index[root] = low[root] = counter++;
+            sccStack.push_back(root);
+            onStack[root] = 1;
+
+            while (!callStack.empty()) {
+                int v = callStack.back().first;
+                uint32_t& e = callStack.back().second;
+                bool descended = false;
+                while (e < offsets_[v + 1]) {
+                    uint32_t edge = e++;
+                    if (chars_[edge] != EPSILON_CHAR) continue;
+                    int w = (int)targets_[edge];
+                    if (index[w] < 0) {
+                        index[w] = low[w] = counter++;
+                        sccStack.push_back(w);
+                        onStack[w] = 1;
+                        callStack.push_back({w, offsets_[w]});
+                        descended = true;
+                        break;
+                    }
+                    if (onStack[w]) low[v] = std::min(low[v], index[w]);
+                }
+                if (descended) continue;
+
+                // v 的所有边处理完毕
+                if (low[v] == index[v]) {
+                    int comp = (int)(closurePool_.size() / std::max<size_t>(closureWords_, 1));
+                    closurePool_.resize(closurePool_.size() + closureWords_, 0);
+                    uint64_t* bits = closurePool_.data() + (size_t)comp * closureWords_;
+                    size_t members = sccStack.size();
+                    while (true) {
+                        int w = sccStack[--members];
+                        onStack[w] = 0;
+                        closureIndex_[w] = comp;
+                        bits[w >> 6] |= 1ull << (w & 63);
+                        if (w == v) break;
+                    }
+                    // 并入所有后继分量的闭包（它们已经完成）
+                    for (size_t i = members; i < sccStack.size(); i++) {
+                        int u = sccStack[i];
+                        for (uint32_t edge = offsets_[u]; edge < offsets_[u + 1]; edge++) {
+                            if (chars_[edge] != EPSILON_CHAR) continue;
+                            int c = closureIndex_[targets_[edge]];
+                            if (c == comp) continue;
+                            const uint64_t* other = closurePool_.data() + (size_t)c * closureWords_;
+                            for (size_t j = 0; j < closureWords_; j++) bits[j] |= other[j];
+                        }
+                    }
+                    sccStack.resize(members);
+                }
+                callStack.pop_back();
+                if (!callStack.empty()) {
+                    int parent = callStack.back().first;
+                    low[parent] = std::min(low[parent], low[v]);
+                }
+            }
+        }
+    }
+
+    size_t n_;
+    std::vector<uint32_t> offsets_;
+    std::vector<uint32_t> targets_;
+    std::vector<char> chars_;
+    std::vector<char> alphabet_;
+    StateSet finals_;
+    std::vector<uint32_t> tags_;
+    int start_ = 0;
+
+    bool closureTableEnabled_ = false;
+    std::vector<int> closureIndex_;
+    std::vector<uint64_t> closurePool_;
+    size_t closureWords_ = 0;
+};
+
+// 第 finalIdCnt 个终态的名字：Y, Y1, Y2 ...
+std::string finalName(int finalIdCnt) {
+    return finalIdCnt == 0 ? std::string("Y") : "Y" + std::to_string(finalIdCnt);
+}
+
+// 串行子集构造：BFS 展开，新状态按发现顺序编号、命名
+void determinizeSerial(const NFAGraph& nfa, const StateSet& startSet, const std::vector<char>& symbols,
+                       std::vector<std::string>& dfaNames, std::vector<int>& dfaTrans, std::vector<uint32_t>& dfaTags,
+                       DeterminizeStats& stats) {
+    const size_t k = symbols.size();
+
+    // 状态映射：NFA状态集合 -> DFA状态编号（即在 dfaNames 中的下标）
+    SubsetTable subsetToDfaId(nfa.words());
+    // move 缓存：move 的结果 -> DFA状态编号。不同DFA状态经同一字符常常 move 到同一个集合，
+    // 命中时无需再求闭包和查子集表
+    SubsetTable moveCache(nfa.words());
+    std::vector<int> moveCacheTarget;
+    // 队列：待处理的DFA状态。DFA状态按发现顺序编号，因此队列就是编号的递增序列
+    int nextToProcess = 0;
+
+    int processIdCnt = 0; // 0, 1, 2...
+    int finalIdCnt = 0;   // Y, Y1, Y2...
+
+    subsetToDfaId.insert(startSet);
+    dfaNames.push_back("X");
+    dfaTags.push_back(nfa.tagOf(startSet));
+    dfaTrans.resize(k, -1);
+
+    while (nextToProcess < subsetToDfaId.size()) {
+        int currentId = nextToProcess++;
+        StateSet currentSet = subsetToDfaId.get(currentId);
+
+        // 对字母表中的每个符号进行转移
+        for (size_t a = 0; a < k; a++) {
+            // move(T, a)
+            StateSet temp = nfa.moveSet(currentSet, symbols[a]);
+            if (temp.empty()) continue;
+
+            temp.computeHash();
+            int cached = moveCache.find(temp);
+            if (cached >= 0) {
+                stats.moveCacheHits++;
+                dfaTrans[(size_t)currentId * k + a] = moveCacheTarget[cached];
+                continue;
+            }
+            stats.moveCacheMisses++;
+
+            // epsilon-closure(move(T, a))
+            StateSet nextSet = nfa.closure(temp);
+
+            int nextId = subsetToDfaId.find(nextSet);
+            if (nextId < 0) {
+                // 命名逻辑
+                if (nfa.isFinalSet(nextSet)) dfaNames.push_back(finalName(finalIdCnt++));
+                else dfaNames.push_back(std::to_string(processIdCnt++));
+                dfaTags.push_back(nfa.tagOf(nextSet));
+
+                nextId = subsetToDfaId.insert(nextSet);
+                dfaTrans.resize(dfaTrans.size() + k, -1);
+            }
+
+            moveCache.insert(temp);
+            moveCacheTarget.push_back(nextId);
+
+            // 记录边
+            dfaTrans[(size_t)currentId * k + a] = nextId;
+        }
+    }
+}
+
+// ---------------- 并行子集构造 ----------------
+// 展开不同的DFA状态互不相关，唯一的共享数据是 子集 -> 状态 的表。
+// 各线程从自己的双端队列取待展开的子集（队列空了就去别的线程的队列偷），
+// 新子集插入按 hash 分片加锁的并发表。线程得到的状态编号取决于调度，
+// 所以最后按串行算法的BFS顺序重新编号、命名，输出与串行版本完全相同。
+
+// 按 hash 分片的并发子集表，每片一把锁
+struct ConcurrentSubsetTable {
+    static const int SHARD_BITS = 6;
+    struct Shard {
+        std::mutex m;
+        SubsetTable table;
+        std::vector<int> globalIds; // 片内编号 -> 全局编号
+        explicit Shard(size_t words) : table(words) {}
+    };
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<int> counter;
+
+    explicit ConcurrentSubsetTable(size_t words) : counter(0) {
+        for (int i = 0; i < (1 << SHARD_BITS); i++) shards.emplace_back(new Shard(words));
+    }
+
+    // 返回子集的全局编号；inserted 表示是否为本次新插入
+    int findOrInsert(const StateSet& set, bool& inserted) {
+        Shard& shard = *shards[set.hash >> (64 - SHARD_BITS)];
+        std::lock_guard<std::mutex> lock(shard.m);
+        int local = shard.table.find(set);
+        if (local >= 0) {
+            inserted = false;
+            return shard.globalIds[local];
+        }
+        shard.table.insert(set);
+        int id = counter.fetch_add(1);
+        shard.globalIds.push_back(id);
+        inserted = true;
+        return id;
+    }
+};
+
+struct WorkItem {
+    int id;
+    StateSet set;
+};
+
+// 加锁的双端队列：所有者从尾部存取，其他线程从头部偷
+struct WorkDeque {
+    std::mutex m;
+    std::deque<WorkItem> items;
+
+    void push(WorkItem&& item) {
+        std::lock_guard<std::mutex> lock(m);
+        items.push_back(std::move(item));
+    }
+    bool pop(WorkItem& item) {
+        std::lock_guard<std::mutex> lock(m);
+        if (items.empty()) return false;
+        item = std::move(items.back());
+        items.pop_back();
+        return true;
+    }
+    bool steal(WorkItem& item) {
+        std::lock_guard<std::mutex> lock(m);
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        return true;
+    }
+};
+
+// 并行构造DFA，结果按串行算法的编号和命名写入 dfaNames / dfaTrans / dfaTags
+void determinizeParallel(const NFAGraph& nfa, const StateSet& startSet, const std::vector<char>& symbols,
+                         unsigned threadCount, std::vector<std::string>& dfaNames, std::vector<int>& dfaTrans,
+                         std::vector<uint32_t>& dfaTags, DeterminizeStats& stats) {
+    const size_t k = symbols.size();
+    const size_t words = nfa.words();
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+
+    struct Edge {
+        int from;
+        int symbol;
+        int to;
+    };
+    struct WorkerResult {
+        std::vector<Edge> edges;
+        std::vector<int> finals; // 本线程发现的终态子集的编号
+        std::vector<std::pair<int, uint32_t>> tags; // 本线程发现的带标记子集：(编号, 标记)
+        size_t hits = 0, misses = 0;
+    };
+
+    ConcurrentSubsetTable table(words);
+    std::vector<std::unique_ptr<WorkDeque>> deques;
+    for (unsigned t = 0; t < threadCount; t++) deques.emplace_back(new WorkDeque());
+    std::vector<WorkerResult> results(threadCount);
+    // 已入队但尚未展开完的子集数，为 0 时所有线程退出
+    std::atomic<long> pending(1);
+
+    bool inserted;
+    int startId = table.findOrInsert(startSet, inserted);
+    deques[0]->push({startId, startSet});
+
+    auto worker = [&](unsigned self) {
+        WorkerResult& result = results[self];
+        // 每个线程自己的 move 结果缓存
+        SubsetTable moveCache(words);
+        std::vector<int> moveCacheTarget;
+        WorkItem item;
+        while (true) {
+            bool got = deques[self]->pop(item);
+            for (unsigned i = 1; !got && i < threadCount; i++) {
+                got = deques[(self + i) % threadCount]->steal(item);
+            }
+            if (!got) {
+                if (pending.load() == 0) break;
+                std::this_thread::yield();
+                continue;
+            }
+
+            for (size_t a = 0; a < k; a++) {
+                StateSet temp = nfa.moveSet(item.set, symbols[a]);
+                if (temp.empty()) continue;
+
+                temp.computeHash();
+                int cached = moveCache.find(temp);
+                if (cached >= 0) {
+                    result.hits++;
+                    result.edges.push_back({item.id, (int)a, moveCacheTarget[cached]});
+                    continue;
+                }
+                result.misses++;
+
+                StateSet nextSet = nfa.closure(temp);
+                bool isNew;
+                int nextId = table.findOrInsert(nextSet, isNew);
+                if (isNew) {
+                    if (nfa.isFinalSet(nextSet)) result.finals.push_back(nextId);
+                    uint32_t tag = nfa.tagOf(nextSet);
+                    if (tag != NO_TAG) result.tags.push_back({nextId, tag});
+                    pending.fetch_add(1);
+                    deques[self]->push({nextId, std::move(nextSet)});
+                }
+                moveCache.insert(temp);
+                moveCacheTarget.push_back(nextId);
+                result.edges.push_back({item.id, (int)a, nextId});
+            }
+            pending.fetch_sub(1);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threadCount; t++) pool.emplace_back(worker, t);
+    for (auto& t : pool) t.join();
+
+    // 汇总为按临时编号索引的转移表
+    const int n = table.counter.load();
+    std::vector<int> rawTrans((size_t)n * k, -1);
+    std::vector<char> rawFinal(n, 0);
+    std::vector<uint32_t> rawTags(n, NO_TAG);
+    rawTags[startId] = nfa.tagOf(startSet);
+    for (const auto& result : results) {
+        for (const auto& e : result.edges) rawTrans[(size_t)e.from * k + e.symbol] = e.to;
+        for (int id : result.finals) rawFinal[id] = 1;
+        for (const auto& t : result.tags) rawTags[t.first] = t.second;
+        stats.moveCacheHits += result.hits;
+        stats.moveCacheMisses += result.misses;
+    }
+
+    // 按串行算法的顺序重新编号：从 X 出发 BFS，按字母表顺序发现新状态
+    std::vector<int> newId(n, -1);
+    std::vector<int> order;
+    order.reserve(n);
+    newId[startId] = 0;
+    order.push_back(startId);
+    dfaNames.assign(1, "X");
+    int processIdCnt = 0; // 0, 1, 2...
+    int finalIdCnt = 0;   // Y, Y1, Y2...
+    for (size_t head = 0; head < order.size(); head++) {
+        int u = order[head];
+        for (size_t a = 0; a < k; a++) {
+            int v = rawTrans[(size_t)u * k + a];
+            if (v < 0 || newId[v] >= 0) continue;
+            newId[v] = (int)order.size();
+            order.push_back(v);
+            if (rawFinal[v]) dfaNames.push_back(finalName(finalIdCnt++));
+            else dfaNames.push_back(std::to_string(processIdCnt++));
+        }
+    }
+
+    dfaTrans.assign(order.size() * k, -1);
+    dfaTags.assign(order.size(), NO_TAG);
+    for (size_t i = 0; i < order.size(); i++) {
+        dfaTags[i] = rawTags[order[i]];
+        for (size_t a = 0; a < k; a++) {
+            int v = rawTrans[(size_t)order[i] * k + a];
+            if (v >= 0) dfaTrans[i * k + a] = newId[v];
+        }
+    }
+}
+
+} // namespace
+
+namespace {
+
+// determinize 的实现；nfaTags 不为空时同时求出 DFA 各状态的标记，按输出顺序写入 resultTags
+AutomatonData determinizeImpl(const AutomatonData& nfa, const std::vector<uint32_t>* nfaTags,
+                              std::vector<uint32_t>* resultTags, const DeterminizeOptions& options,
+                              DeterminizeStats* stats) {
+    AutomatonData dfa;
+    dfa.flags = FLAG_DETERMINISTIC;
+    if (nfa.stateCount() == 0) {
+        dfa.addState("X", false);
+        if (resultTags) resultTags->assign(1, NO_TAG);
+        return dfa;
+    }
+
+    // 预处理：每个NFA状态的epsilon闭包只计算一次
+    NFAGraph graph(nfa, nfaTags);
+    const std::vector<char>& symbols = graph.alphabet();
+    const size_t k = symbols.size();
+
+    // DFA的转换边：dfaTrans[id * 字母表大小 + 字符下标]，-1 表示无转移
+    std::vector<int> dfaTrans;
+    // DFA状态名，下标即DFA状态编号
+    std::vector<std::string> dfaNames;
+    // DFA状态的标记（没有 nfaTags 时全为 NO_TAG）
+    std::vector<uint32_t> dfaTags;
+    DeterminizeStats localStats;
+    if (options.parallel) {
+        determinizeParallel(graph, graph.startSet(), symbols, options.threads, dfaNames, dfaTrans, dfaTags,
+                            localStats);
+    } else {
+        determinizeSerial(graph, graph.startSet(), symbols, dfaNames, dfaTrans, dfaTags, localStats);
+    }
+    if (stats) *stats = localStats;
+
+    // 题目要求的输出顺序：X最前, Y其次, 数字最后
+    std::vector<int> sortedStates(dfaNames.size());
+    for (size_t i = 0; i < sortedStates.size(); i++) sortedStates[i] = (int)i;
+    std::sort(sortedStates.begin(), sortedStates.end(), [&](int x, int y) {
+        const std::string& a = dfaNames[x];
+        const std::string& b = dfaNames[y];
+        int prioA = (a == "X") ? 0 : (a[0] == 'Y' ? 1 : 2);
+        int prioB = (b == "X") ? 0 : (b[0] == 'Y' ? 1 : 2);
+        if (prioA != prioB) return prioA < prioB;
+        // 同类比较
+        if (a[0] == 'Y' && b[0] == 'Y') {
+            if (a == "Y") return b != "Y";
+            if (b == "Y") return false;
+            return a.length() < b.length() || (a.length() == b.length() && a < b);
+        }
+        if (isdigit((unsigned char)a[0]) && isdigit((unsigned char)b[0])) {
+            return std::stoi(a) < std::stoi(b);
+        }
+        return a < b;
+    });
+
+    std::vector<uint32_t> position(dfaNames.size());
+    for (size_t i = 0; i < sortedStates.size(); i++) position[sortedStates[i]] = (uint32_t)i;
+    for (int id : sortedStates) {
+        dfa.addState(dfaNames[id], dfaNames[id][0] == 'Y');
+        // 边按字符顺序 a, b... 存放
+        for (size_t a = 0; a < k; a++) {
+            int to = dfaTrans[(size_t)id * k + a];
+            if (to >= 0) dfa.addEdge(symbols[a], position[to]);
+        }
+    }
+    dfa.startState = position[0];
+    if (resultTags) {
+        resultTags->resize(sortedStates.size());
+        for (size_t i = 0; i < sortedStates.size(); i++) (*resultTags)[i] = dfaTags[sortedStates[i]];
+    }
+    return dfa;
+}
+
+} // namespace
+
+AutomatonData determinize(const AutomatonData& nfa, const DeterminizeOptions& options, DeterminizeStats* stats) {
+    return determinizeImpl(nfa, nullptr, nullptr, options, stats);
+}
+
+AutomatonData determinize(const AutomatonData& nfa, const std::vector<uint32_t>& nfaTags,
+                          std::vector<uint32_t>& dfaTags, const DeterminizeOptions& options,
+                          DeterminizeStats* stats) {
+    return determinizeImpl(nfa, &nfaTags, &dfaTags, options, stats);
+}
+
+// ---------------- 惰性DFA ----------------
+// 完全确定化可能产生指数多个状态，而匹配时实际走到的往往只是很小一部分。
+// 惰性DFA只在输入第一次走到某个状态/转移时才用 moveSet 和闭包把它构造出来，
+// 构造出的状态放在一个有内存上限的缓存里，超过上限就整体清空重来；
+// 如果清空过于频繁（缓存几乎没起作用），就退回直接模拟NFA。
+struct LazyDFA::Impl {
+    enum {
+        UNKNOWN = -2, // 转移尚未构造
+        DEAD = -1     // 转移到空集
+    };
+
+    NFAGraph nfa;
+    int symbolOf[256];
+    std::vector<char> symbols;
+    size_t k = 0;
+    SubsetTable cache;
+    std::vector<int> trans; // trans[id * k + a]
+    std::vector<char> accepting;
+    StateSet startSet;
+    int startId = -1;
+
+    size_t budget;     // 缓存的内存上限（字节）
+    size_t stateBytes; // 每个缓存状态大约占用的字节数
+    size_t bytesSinceFlush = 0;
+    bool useNFA = false;
+
+    // 统计
+    size_t statesBuilt = 0;
+    size_t flushes = 0;
+    size_t cacheHits = 0;
+
+    Impl(const AutomatonData& data, size_t budgetBytes)
+        : nfa(data), cache(nfa.words()), budget(budgetBytes) {
+        for (int c = 0; c < 256; c++) symbolOf[c] = -1;
+        symbols = nfa.alphabet();
+        k = symbols.size();
+        for (size_t a = 0; a < k; a++) symbolOf[(unsigned char)symbols[a]] = (int)a;
+        startSet = nfa.size() > 0 ? nfa.startSet() : StateSet(0);
+        // 子集位集 + hash + 转移行 + 终态标记 + 哈希槽（按负载 1/2 计）
+        stateBytes = cache.words * sizeof(uint64_t) + sizeof(uint64_t) + k * sizeof(int) + 1 + 2 * sizeof(int);
+    }
+
+    size_t memoryUsed() const { return (size_t)cache.size() * stateBytes; }
+
+    void flush() {
+        // 距上次清空处理的字节数还不到缓存状态数的 10 倍，说明缓存在抖动
+        if (flushes >= 2 && bytesSinceFlush < 10 * (size_t)cache.size()) useNFA = true;
+        flushes++;
+        bytesSinceFlush = 0;
+        cache.clear();
+        trans.clear();
+        accepting.clear();
+        startId = -1;
+    }
+
+    int addState(const StateSet& set) {
+        if (memoryUsed() + stateBytes > budget) flush();
+        int id = cache.insert(set);
+        trans.resize(trans.size() + k, UNKNOWN);
+        accepting.push_back(nfa.isFinalSet(set));
+        statesBuilt++;
+        return id;
+    }
+
+    // 状态 id 经字符下标 a 的转移，必要时构造目标状态
+    int step(int id, int a) {
+        int to = trans[(size_t)id * k + a];
+        if (to != UNKNOWN) {
+            cacheHits++;
+            return to;
+        }
+        StateSet next = nfa.closure(nfa.moveSet(cache.get(id), symbols[a]));
+        if (next.empty()) {
+            to = DEAD;
+        } else {
+            to = cache.find(next);
+            if (to < 0) {
+                size_t before = flushes;
+                to = addState(next);
+                // 发生了清空，id 已经失效，不再记录这条转移
+                if (flushes != before) return to;
+            }
+        }
+        trans[(size_t)id * k + a] = to;
+        return to;
+    }
+
+    // 从集合 curr 出发直接模拟NFA
+    bool matchNFA(StateSet curr, const char* s, size_t len) const {
+        for (size_t i = 0; i < len; i++) {
+            int a = symbolOf[(unsigned char)s[i]];
+            if (a < 0) return false;
+            curr = nfa.closure(nfa.moveSet(curr, symbols[a]));
+            if (curr.empty()) return false;
+        }
+        return nfa.isFinalSet(curr);
+    }
+
+    bool match(const char* s, size_t len) {
+        if (nfa.size() == 0) return false;
+        if (useNFA) return matchNFA(startSet, s, len);
+        if (startId < 0) startId = addState(startSet);
+        int curr = startId;
+        for (size_t i = 0; i < len; i++) {
+            int a = symbolOf[(unsigned char)s[i]];
+            if (a < 0) return false;
+            curr = step(curr, a);
+            bytesSinceFlush++;
+            if (curr == DEAD) return false;
+            // 本串匹配途中缓存抖动，剩余部分改为模拟NFA
+            if (useNFA) return matchNFA(cache.get(curr), s + i + 1, len - i - 1);
+        }
+        return accepting[curr] != 0;
+    }
+};
+
+LazyDFA::LazyDFA(const AutomatonData& nfa, size_t budgetBytes) : impl_(new Impl(nfa, budgetBytes)) {}
+
+LazyDFA::~LazyDFA() {}
+
+bool LazyDFA::match(const char* s, size_t len) {
+    return impl_->match(s, len);
+}
+
+LazyDFAStats LazyDFA::stats() const {
+    LazyDFAStats result;
+    result.statesBuilt = impl_->statesBuilt;
+    result.cached = (size_t)impl_->cache.size();
+    result.cacheHits = impl_->cacheHits;
+    result.flushes = impl_->flushes;
+    result.fellBackToNFA = impl_->useNFA;
+    return result;
+}
+
+} // namespace automata
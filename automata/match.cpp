@@ -0,0 +1,234 @@
+// DFA 识别：稠密转移表与多路交错内核
+
+#include "automata.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define AUTOMATA_HAVE_AVX2_KERNEL
+#endif
+
+namespace automata {
+
+namespace {
+
+// View 为 AutomatonData 或 AutomatonView
+template <class View>
+DenseDFA buildDense(const View& dfa, uint32_t start) {
+    DenseDFA dense;
+    size_t n = dfa.stateCount();
+    if (n == 0) {
+        // 空自动机：只有一个不接受任何串的状态
+        dense.table.assign(256, DEAD_STATE);
+        dense.accepting.assign(1, 0);
+        dense.start = 0;
+        return dense;
+    }
+    dense.table.assign(n * 256, DEAD_STATE);
+    dense.accepting.assign(n, 0);
+    for (uint32_t s = 0; s < n; s++) {
+        for (uint32_t e = dfa.edgeOffsets[s]; e < dfa.edgeOffsets[s + 1]; e++) {
+            dense.table[(size_t)s * 256 + (unsigned char)dfa.symbol(e)] = dfa.edgeTargets[e];
+        }
+        dense.accepting[s] = dfa.isAccepting(s);
+    }
+    dense.start = start;
+    return dense;
+}
+
+} // namespace
+
+DenseDFA buildDenseDFA(const AutomatonData& dfa) { return buildDense(dfa, dfa.startState); }
+
+DenseDFA buildDenseDFA(const AutomatonView& dfa) { return buildDense(dfa, dfa.startState()); }
+
+bool match(const DenseDFA& dfa, const char* s, size_t len, size_t* consumed) {
+    const uint32_t* table = dfa.table.data();
+    uint32_t curr = dfa.start;
+    for (size_t i = 0; i < len; i++) {
+        uint32_t next = table[(size_t)curr * 256 + (unsigned char)s[i]];
+        if (next == DEAD_STATE) {
+            if (consumed) *consumed = i;
+            return false;
+        }
+        curr = next;
+    }
+    if (consumed) *consumed = len;
+    return dfa.accepting[curr] != 0;
+}
+
+// ---------------- 多路交错识别 ----------------
+// 单个串的识别中，下一次查表依赖上一次的结果，瓶颈是访存延迟。
+// 把若干个互不相关的串放在不同的"路"里同时推进，每一步为每一路各查一次表，
+// 这些查表互不依赖，可以同时在途。某一路的串结束或出错后立即换上下一个串。
+
+namespace {
+
+template <int LANES>
+void matchManyScalar(const DenseDFA& dfa, const std::vector<Span>& inputs, std::vector<uint8_t>& verdicts) {
+    const uint32_t* table = dfa.table.data();
+    const uint8_t* accepting = dfa.accepting.data();
+    verdicts.assign(inputs.size(), 0);
+
+    const unsigned char* ptr[LANES];
+    const unsigned char* end[LANES];
+    uint32_t state[LANES];
+    size_t owner[LANES];
+    size_t next = 0;
+    int active = 0;
+
+    // 为第 l 路装入下一个串；空串直接判定
+    auto refill = [&](int l) -> bool {
+        while (next < inputs.size()) {
+            size_t i = next++;
+            if (inputs[i].len == 0) {
+                verdicts[i] = accepting[dfa.start];
+                continue;
+            }
+            ptr[l] = (const unsigned char*)inputs[i].s;
+            end[l] = ptr[l] + inputs[i].len;
+            state[l] = dfa.start;
+            owner[l] = i;
+            return true;
+        }
+        return false;
+    };
+
+    for (int l = 0; l < LANES; l++) {
+        if (!refill(l)) break;
+        active++;
+    }
+
+    while (active > 0) {
+        for (int l = 0; l < active; l++) {
+            uint32_t to = table[(size_t)state[l] * 256 + *ptr[l]++];
+            state[l] = to;
+            bool finished = to == DEAD_STATE || ptr[l] == end[l];
+            if (!finished) continue;
+            verdicts[owner[l]] = to != DEAD_STATE && accepting[to];
+            if (!refill(l)) {
+                // 没有新串可装，把最后一路挪到这里，缩小活跃路数
+                active--;
+                ptr[l] = ptr[active];
+                end[l] = end[active];
+                state[l] = state[active];
+                owner[l] = owner[active];
+                l--;
+            }
+        }
+    }
+}
+
+#ifdef AUTOMATA_HAVE_AVX2_KERNEL
+// AVX2 版本：8 路的下标一次算出，用 gather 同时取 8 个转移
+__attribute__((target("avx2")))
+void matchManyAVX2(const DenseDFA& dfa, const std::vector<Span>& inputs, std::vector<uint8_t>& verdicts) {
+    const int LANES = 8;
+    const uint32_t* table = dfa.table.data();
+    const uint8_t* accepting = dfa.accepting.data();
+    verdicts.assign(inputs.size(), 0);
+
+    static const unsigned char idle = 0;
+    const unsigned char* ptr[LANES];
+    const unsigned char* end[LANES];
+    size_t step[LANES];
+    size_t owner[LANES];
+    alignas(32) uint32_t state[LANES];
+    alignas(32) uint32_t bytes[LANES];
+    size_t next = 0;
+    int active = 0;
+
+    auto refill = [&](int l) -> bool {
+        while (next < inputs.size()) {
+            size_t i = next++;
+            if (inputs[i].len == 0) {
+                verdicts[i] = accepting[dfa.start];
+                continue;
+            }
+            ptr[l] = (const unsigned char*)inputs[i].s;
+            end[l] = ptr[l] + inputs[i].len;
+            state[l] = dfa.start;
+            step[l] = 1;
+            owner[l] = i;
+            return true;
+        }
+        // 空闲的路停在一个合法的位置上不再前进，gather 的结果被忽略
+        ptr[l] = &idle;
+        end[l] = nullptr;
+        step[l] = 0;
+        state[l] = 0;
+        owner[l] = (size_t)-1;
+        return false;
+    };
+
+    for (int l = 0; l < LANES; l++) {
+        if (refill(l)) active++;
+    }
+
+    // 状态留在寄存器里，只有某一路结束时才写回内存处理
+    const __m256i dead = _mm256_set1_epi32((int)DEAD_STATE);
+    __m256i st = _mm256_load_si256((const __m256i*)state);
+    while (active > 0) {
+        unsigned finishMask = 0;
+        for (int l = 0; l < LANES; l++) {
+            bytes[l] = *ptr[l];
+            ptr[l] += step[l];
+            finishMask |= (unsigned)(ptr[l] == end[l]) << l;
+        }
+        __m256i by = _mm256_load_si256((const __m256i*)bytes);
+        __m256i idx = _mm256_add_epi32(_mm256_slli_epi32(st, 8), by);
+        st = _mm256_i32gather_epi32((const int*)table, idx, 4);
+        unsigned deadMask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(st, dead)));
+        finishMask |= deadMask;
+        if (!finishMask) continue;
+
+        _mm256_store_si256((__m256i*)state, st);
+        for (int l = 0; l < LANES; l++) {
+            if (!((finishMask >> l) & 1) || owner[l] == (size_t)-1) continue;
+            bool isDead = (deadMask >> l) & 1;
+            verdicts[owner[l]] = !isDead && accepting[state[l]];
+            if (!refill(l)) active--;
+        }
+        // 空闲的路可能停在 DEAD_STATE 上，重置为 0 以免下标越界
+        for (int l = 0; l < LANES; l++) {
+            if (owner[l] == (size_t)-1) state[l] = 0;
+        }
+        st = _mm256_load_si256((const __m256i*)state);
+    }
+}
+#endif
+
+} // namespace
+
+bool cpuHasAVX2() {
+#ifdef AUTOMATA_HAVE_AVX2_KERNEL
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+void matchMany(const DenseDFA& dfa, const std::vector<Span>& inputs, std::vector<uint8_t>& verdicts,
+               MatchKernel kernel) {
+    switch (kernel) {
+    case MatchKernel::Scalar8:
+        matchManyScalar<8>(dfa, inputs, verdicts);
+        return;
+    case MatchKernel::AVX2:
+#ifdef AUTOMATA_HAVE_AVX2_KERNEL
+        // gather 的下标 状态 * 256 + 字节 是有符号 32 位数，状态数达到 2^23 时会溢出
+        if (cpuHasAVX2() && dfa.accepting.size() < (1u << 23)) {
+            matchManyAVX2(dfa, inputs, verdicts);
+            return;
+        }
+#endif
+        // CPU 不支持或状态太多时退回标量版本
+        matchManyScalar<16>(dfa, inputs, verdicts);
+        return;
+    case MatchKernel::Scalar16:
+    default:
+        matchManyScalar<16>(dfa, inputs, verdicts);
+        return;
+    }
+}
+
+} // namespace automata
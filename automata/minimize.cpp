@@ -0,0 +1,254 @@
+// DFA 最小化（Hopcroft 算法）
+
+#include "automata.h"
+
+#include <algorithm>
+
+namespace automata {
+
+namespace {
+
+// 输出顺序：X, Y, 然后按数字大小；不是数字的名字按字典序
+bool stateComparator(const std::string& a, const std::string& b) {
+    if (a == "X") return true;
+    if (b == "X") return false;
+    if (a == "Y") return true;
+    if (b == "Y") return false;
+    try {
+        int na = std::stoi(a);
+        int nb = std::stoi(b);
+        return na < nb;
+    } catch (...) {
+        return a < b;
+    }
+}
+
+// Hopcroft 算法使用的可细分划分 (refinable partition)
+// elems 是所有状态的一个排列，同一组的状态在 elems 中连续存放：
+// 组 g 占据 [first[g], last[g])，其中前 marked[g] 个是本轮被标记的状态
+struct Partition {
+    std::vector<int> elems, loc, setOf;
+    std::vector<int> first, last, marked;
+
+    explicit Partition(int n) : elems(n), loc(n), setOf(n, 0) {
+        for (int i = 0; i < n; ++i) elems[i] = loc[i] = i;
+        if (n > 0) {
+            first.push_back(0);
+            last.push_back(n);
+            marked.push_back(0);
+        }
+    }
+
+    int size() const { return (int)first.size(); }
+
+    // 把状态 s 移到所在组的已标记区
+    void mark(int s) {
+        int g = setOf[s];
+        int i = loc[s];
+        int j = first[g] + marked[g];
+        if (i < j) return; // 已经标记过
+        std::swap(elems[i], elems[j]);
+        loc[elems[i]] = i;
+        loc[elems[j]] = j;
+        ++marked[g];
+    }
+
+    // 把组 g 的已标记部分分裂出来成为新组，返回新组编号；不需要分裂时返回 -1
+    int split(int g) {
+        int m = marked[g];
+        marked[g] = 0;
+        if (m == 0 || m == last[g] - first[g]) return -1;
+        int ng = size();
+        first.push_back(first[g]);
+        last.push_back(first[g] + m);
+        marked.push_back(0);
+        first[g] += m;
+        for (int i = first[ng]; i < last[ng]; ++i) setOf[elems[i]] = ng;
+        return ng;
+    }
+};
+
+// minimize 的实现；tags 不为空时只合并标记相同的状态，并按输出顺序把各组的标记写入 resultTags
+AutomatonData minimizeImpl(const AutomatonData& dfa, const std::vector<uint32_t>* tags,
+                           std::vector<uint32_t>* resultTags) {
+    // 1. 状态按名字的字典序编号（代表的选取和输出顺序都依赖这个顺序）
+    const int n = (int)dfa.stateCount();
+    std::vector<int> byName(n);
+    for (int s = 0; s < n; ++s) byName[s] = s;
+    std::sort(byName.begin(), byName.end(), [&](int x, int y) { return dfa.names[x] < dfa.names[y]; });
+    std::vector<int> stateId(n);
+    for (int i = 0; i < n; ++i) stateId[byName[i]] = i;
+    auto nameOf = [&](int s) -> const std::string& { return dfa.names[byName[s]]; };
+
+    // 字母表按字符升序
+    bool seen[256] = {false};
+    for (uint32_t e = 0; e < dfa.edgeCount(); ++e) seen[(unsigned char)dfa.symbol(e)] = true;
+    std::vector<char> symbols;
+    for (int c = -128; c < 128; ++c) {
+        if (seen[(unsigned char)(char)c]) symbols.push_back((char)c);
+    }
+    int symbolIndex[256];
+    for (int i = 0; i < (int)symbols.size(); ++i) symbolIndex[(unsigned char)symbols[i]] = i;
+    const int k = (int)symbols.size();
+
+    // delta[s * k + a]：缺失的转移为 -1；同一状态同一字符出现多次时以最后一次为准
+    std::vector<int> delta((size_t)n * k, -1);
+    for (uint32_t s = 0; s < (uint32_t)n; ++s)
+        for (uint32_t e = dfa.edgeOffsets[s]; e < dfa.edgeOffsets[s + 1]; ++e)
+            delta[(size_t)stateId[s] * k + symbolIndex[(unsigned char)dfa.symbol(e)]] = stateId[dfa.edgeTargets[e]];
+
+    // 缺失的转移统一指向一个补充的死状态（编号 n），保证转移函数完全
+    bool needDead = false;
+    for (int t : delta) {
+        if (t < 0) {
+            needDead = true;
+            break;
+        }
+    }
+    const int total = n + (needDead ? 1 : 0);
+    auto target = [&](int s, int a) { return (s == n || delta[(size_t)s * k + a] < 0) ? n : delta[(size_t)s * k + a]; };
+
+    // 2. 逆转移表 (CSR)：preds[predStart[t * k + a] .. predStart[t * k + a + 1]) 是经 a 到达 t 的状态
+    std::vector<int> predStart((size_t)total * k + 1, 0);
+    for (int s = 0; s < total; ++s)
+        for (int a = 0; a < k; ++a) ++predStart[(size_t)target(s, a) * k + a + 1];
+    for (size_t i = 1; i < predStart.size(); ++i) predStart[i] += predStart[i - 1];
+    std::vector<int> preds(predStart.back());
+    {
+        std::vector<int> fill(predStart.begin(), predStart.end() - 1);
+        for (int s = 0; s < total; ++s)
+            for (int a = 0; a < k; ++a) preds[fill[(size_t)target(s, a) * k + a]++] = s;
+    }
+
+    // 3. 初始划分：终态组 与 非终态组；有标记时再把带标记的状态按标记分开（补充的死状态没有标记）
+    Partition part(total);
+    for (int s = 0; s < n; ++s)
+        if (dfa.isAccepting(byName[s])) part.mark(s);
+    if (total > 0) part.split(0);
+    if (tags) {
+        std::vector<std::pair<uint32_t, int>> tagged; // (标记, 状态)，同一标记的状态相邻
+        for (int s = 0; s < n; ++s)
+            if ((*tags)[byName[s]] != NO_TAG) tagged.push_back({(*tags)[byName[s]], s});
+        std::sort(tagged.begin(), tagged.end());
+        for (size_t i = 0; i < tagged.size();) {
+            size_t j = i;
+            while (j < tagged.size() && tagged[j].first == tagged[i].first) ++j;
+            // 同一标记的状态可能分布在终态组和非终态组中，逐组标记后分裂
+            std::vector<int> groupsTouched;
+            for (size_t t = i; t < j; ++t) {
+                int g = part.setOf[tagged[t].second];
+                if (part.marked[g] == 0) groupsTouched.push_back(g);
+                part.mark(tagged[t].second);
+            }
+            for (int g : groupsTouched) part.split(g);
+            i = j;
+        }
+    }
+
+    // 4. 待处理的分割器 (组, 字符)。初始时放入除最大的一组以外的所有组
+    //    （只有终态/非终态两组时即较小的一组）
+    std::vector<std::pair<int, int>> work;
+    std::vector<char> inWork;
+    auto pushWork = [&](int g, int a) {
+        if ((size_t)g * k + a >= inWork.size()) inWork.resize((size_t)(g + 1) * k, 0);
+        if (inWork[(size_t)g * k + a]) return;
+        inWork[(size_t)g * k + a] = 1;
+        work.push_back({g, a});
+    };
+    if (total > 0) {
+        int largest = 0;
+        for (int g = 1; g < part.size(); ++g)
+            if (part.last[g] - part.first[g] >= part.last[largest] - part.first[largest]) largest = g;
+        if (part.size() == 1) largest = -1;
+        for (int g = 0; g < part.size(); ++g) {
+            if (g == largest) continue;
+            for (int a = 0; a < k; ++a) pushWork(g, a);
+        }
+    }
+
+    std::vector<int> touchedStates, touchedGroups;
+    while (!work.empty()) {
+        int splitter = work.back().first;
+        int a = work.back().second;
+        work.pop_back();
+        inWork[(size_t)splitter * k + a] = 0;
+
+        // 收集经 a 进入 splitter 的所有状态，先收集再标记，避免标记过程中 splitter 本身被改动
+        touchedStates.clear();
+        for (int i = part.first[splitter]; i < part.last[splitter]; ++i) {
+            int t = part.elems[i];
+            for (int j = predStart[(size_t)t * k + a]; j < predStart[(size_t)t * k + a + 1]; ++j)
+                touchedStates.push_back(preds[j]);
+        }
+
+        touchedGroups.clear();
+        for (int s : touchedStates) {
+            int g = part.setOf[s];
+            if (part.marked[g] == 0) touchedGroups.push_back(g);
+            part.mark(s);
+        }
+
+        for (int g : touchedGroups) {
+            int ng = part.split(g);
+            if (ng < 0) continue;
+            int sizeOld = part.last[g] - part.first[g];
+            int sizeNew = part.last[ng] - part.first[ng];
+            for (int b = 0; b < k; ++b) {
+                bool pending = (size_t)g * k + b < inWork.size() && inWork[(size_t)g * k + b];
+                if (pending || sizeNew <= sizeOld) pushWork(ng, b);
+                else pushWork(g, b);
+            }
+        }
+    }
+
+    // 5. 构建输出结果
+    // 每组的代表：含 X 取 X，否则含 Y 取 Y，否则取字典序最小的状态名
+    std::vector<int> representative(part.size(), -1);
+    for (int s = 0; s < n; ++s) {
+        int g = part.setOf[s];
+        int& r = representative[g];
+        if (r < 0) r = s; // 状态按字典序编号，第一个即最小
+        if (nameOf(s) == "X") r = s;
+        else if (nameOf(s) == "Y" && nameOf(r) != "X") r = s;
+    }
+
+    // 只含补充死状态的组不输出；其余按 X, Y, 0, 1... 排序
+    std::vector<int> groups;
+    for (int g = 0; g < part.size(); ++g)
+        if (representative[g] >= 0) groups.push_back(g);
+    std::sort(groups.begin(), groups.end(), [&](int x, int y) {
+        return stateComparator(nameOf(representative[x]), nameOf(representative[y]));
+    });
+    std::vector<uint32_t> position(part.size(), 0);
+    for (size_t i = 0; i < groups.size(); ++i) position[groups[i]] = (uint32_t)i;
+
+    AutomatonData result;
+    result.flags = FLAG_DETERMINISTIC;
+    for (int g : groups) {
+        int rep = representative[g];
+        result.addState(nameOf(rep), dfa.isAccepting(byName[rep]));
+        for (int a = 0; a < k; ++a) {
+            int rawTarget = delta[(size_t)rep * k + a];
+            if (rawTarget < 0) continue;
+            result.addEdge(symbols[a], position[part.setOf[rawTarget]]);
+        }
+        if (nameOf(rep) == "X") result.startState = result.stateCount() - 1;
+    }
+    if (resultTags) {
+        resultTags->clear();
+        for (int g : groups) resultTags->push_back((*tags)[byName[representative[g]]]);
+    }
+    return result;
+}
+
+} // namespace
+
+AutomatonData minimize(const AutomatonData& dfa) {
+    return minimizeImpl(dfa, nullptr, nullptr);
+}
+
+AutomatonData minimize(const AutomatonData& dfa, const std::vector<uint32_t>& tags, std::vector<uint32_t>& resultTags) {
+    return minimizeImpl(dfa, &tags, &resultTags);
+}
+
+} // namespace automata
@@ -0,0 +1,525 @@
+// 正规式 → NFA（Thompson / Glushkov）以及由 followpos 直接构造DFA
+
+#include "automata.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace automata {
+
+namespace {
+
+// 边：状态用整数编号表示，'~' 代表 Epsilon (空边)
+struct NFAEdge {
+    int from;
+    int to;
+    char pathChar;
+};
+
+// 状态和边都放在 NFAArena 的扁平数组里，构造过程中不为单个状态分配内存。
+// 子图之间只通过状态编号相连，* 产生的回边也只是一条普通的边
+struct NFAArena {
+    int stateCount = 0;
+    std::vector<NFAEdge> edges;
+    std::vector<int> nextInOrder; // 结构顺序链表，-1 表示链尾
+
+    // 按正规式长度预留空间：每个字符/运算符最多新建 2 个状态、4 条边
+    void reserve(size_t regexLength) {
+        edges.reserve(regexLength * 4 + 4);
+        nextInOrder.reserve(regexLength * 2 + 2);
+    }
+
+    int newState() {
+        nextInOrder.push_back(-1);
+        return stateCount++;
+    }
+
+    // 把状态 b 接在链尾 a 之后
+    void link(int a, int b) { nextInOrder[a] = b; }
+
+    void addEdge(int from, int to, char pathChar) { edges.push_back({from, to, pathChar}); }
+
+    // 转成 CSR：状态 u 的出边为 adj[start[u] .. start[u + 1])，保持添加边的顺序
+    void toAdjacency(std::vector<int>& start, std::vector<NFAEdge>& adj) const {
+        start.assign(stateCount + 1, 0);
+        for (const auto& e : edges) ++start[e.from + 1];
+        for (int i = 0; i < stateCount; ++i) start[i + 1] += start[i];
+        adj.resize(edges.size());
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (const auto& e : edges) adj[fill[e.from]++] = e;
+    }
+};
+
+// NFA 片段：唯一的入口(head)和出口(tail)。
+// 片段内的状态还按结构顺序串成一条链 (orderFirst -> ... -> orderLast，链接存放在 arena.nextInOrder)：
+// 字符为 起点、终点；连接为 A 的链、B 的链；并集为 新起点、A、B、新终点；闭包为 新起点、A、新终点。
+// 评测要求的状态编号就是这个顺序
+struct NFAFragment {
+    int headNode;
+    int tailNode;
+    int orderFirst;
+    int orderLast;
+};
+
+bool isOperator(char c) {
+    return c == '|' || c == '*' || c == '.' || c == '(' || c == ')';
+}
+
+int precedence(char op) {
+    if (op == '*') return 3;
+    if (op == '.') return 2;
+    if (op == '|') return 1;
+    return 0;
+}
+
+// 1. 插入显式连接符 '.'
+std::string addConcatSymbol(const std::string& regex) {
+    std::string res;
+    res.reserve(regex.size() * 2);
+    for (size_t i = 0; i < regex.size(); ++i) {
+        char c1 = regex[i];
+        res += c1;
+        if (i + 1 < regex.size()) {
+            char c2 = regex[i + 1];
+            // 如果 c1 是 字符/*/) 且 c2 是 字符/(，则中间需要加点
+            bool c1Valid = !isOperator(c1) || c1 == '*' || c1 == ')';
+            bool c2Valid = !isOperator(c2) || c2 == '(';
+            if (c1Valid && c2Valid) res += '.';
+        }
+    }
+    return res;
+}
+
+// 2. 中缀转后缀 (Shunting-yard)，括号不匹配时返回 false
+bool infixToPostfix(const std::string& regex, std::string& postfix) {
+    postfix.clear();
+    postfix.reserve(regex.size());
+    std::string opStack;
+    opStack.reserve(regex.size());
+
+    for (char c : regex) {
+        if (!isOperator(c)) {
+            postfix += c;
+        } else if (c == '(') {
+            opStack += c;
+        } else if (c == ')') {
+            while (!opStack.empty() && opStack.back() != '(') {
+                postfix += opStack.back();
+                opStack.pop_back();
+            }
+            if (opStack.empty()) return false;
+            opStack.pop_back(); // 弹出 '('
+        } else {
+            // 处理优先级 *, ., |
+            while (!opStack.empty() && precedence(opStack.back()) >= precedence(c)) {
+                postfix += opStack.back();
+                opStack.pop_back();
+            }
+            opStack += c;
+        }
+    }
+    while (!opStack.empty()) {
+        if (opStack.back() == '(') return false;
+        postfix += opStack.back();
+        opStack.pop_back();
+    }
+    return true;
+}
+
+// 正规式 → 后缀表达式，失败时填写 error
+bool toPostfix(const std::string& regex, std::string& postfix, std::string& error) {
+    if (!infixToPostfix(addConcatSymbol(regex), postfix)) {
+        error = "正规式括号不匹配";
+        return false;
+    }
+    return true;
+}
+
+// 3. Thompson 构造：根据后缀表达式在 arena 中构建 NFA，表达式不合法时返回 false
+bool buildThompson(const std::string& postfix, NFAArena& arena, NFAFragment& result) {
+    std::vector<NFAFragment> st;
+    st.reserve(postfix.size());
+
+    for (char c : postfix) {
+        if (!isOperator(c)) {
+            // 字面量： S -c-> E
+            int s = arena.newState();
+            int e = arena.newState();
+            arena.addEdge(s, e, c);
+            arena.link(s, e);
+            st.push_back({s, e, s, e});
+        } else if (c == '.') {
+            // 连接：A 的结束连一条空边到 B 的开始
+            if (st.size() < 2) return false;
+            NFAFragment b = st.back(); st.pop_back();
+            NFAFragment a = st.back(); st.pop_back();
+            arena.addEdge(a.tailNode, b.headNode, '~');
+            arena.link(a.orderLast, b.orderFirst);
+            st.push_back({a.headNode, b.tailNode, a.orderFirst, b.orderLast});
+        } else if (c == '|') {
+            // 并集： S -> A, S -> B; A -> E, B -> E
+            if (st.size() < 2) return false;
+            NFAFragment b = st.back(); st.pop_back();
+            NFAFragment a = st.back(); st.pop_back();
+            int s = arena.newState();
+            int e = arena.newState();
+            arena.addEdge(s, a.headNode, '~');
+            arena.addEdge(s, b.headNode, '~');
+            arena.addEdge(a.tailNode, e, '~');
+            arena.addEdge(b.tailNode, e, '~');
+            arena.link(s, a.orderFirst);
+            arena.link(a.orderLast, b.orderFirst);
+            arena.link(b.orderLast, e);
+            st.push_back({s, e, s, e});
+        } else if (c == '*') {
+            // 闭包： S -> A, S -> E, A -> A(循环), A -> E
+            if (st.empty()) return false;
+            NFAFragment a = st.back(); st.pop_back();
+            int s = arena.newState();
+            int e = arena.newState();
+            arena.addEdge(s, a.headNode, '~');          // 进入 A
+            arena.addEdge(s, e, '~');                   // 匹配 0 次
+            arena.addEdge(a.tailNode, a.headNode, '~'); // 循环
+            arena.addEdge(a.tailNode, e, '~');          // 离开
+            arena.link(s, a.orderFirst);
+            arena.link(a.orderLast, e);
+            st.push_back({s, e, s, e});
+        }
+    }
+
+    if (st.size() != 1) return false;
+    result = st.back();
+    return true;
+}
+
+// 4. 状态重命名：初态为 X，终态为 Y，其余状态命名为 1, 2, 3...
+//    默认按片段的结构顺序编号；bfs 为 true 时按 BFS 发现顺序编号。
+//    order 为输出顺序（X、Y、1、2 ...），names 为各状态的名字
+void renameStates(const NFAArena& arena, const NFAFragment& nfa, const std::vector<int>& start,
+                  const std::vector<NFAEdge>& adj, bool bfs, std::vector<int>& order,
+                  std::vector<std::string>& names) {
+    names.assign(arena.stateCount, "");
+    names[nfa.headNode] = "X";
+    names[nfa.tailNode] = "Y";
+
+    std::vector<int> numbered;
+    numbered.reserve(arena.stateCount);
+    if (bfs) {
+        std::vector<int> queue;
+        queue.reserve(arena.stateCount);
+        std::vector<char> visited(arena.stateCount, 0);
+        queue.push_back(nfa.headNode);
+        visited[nfa.headNode] = 1;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int u = queue[head];
+            for (int i = start[u]; i < start[u + 1]; ++i) {
+                int v = adj[i].to;
+                if (visited[v]) continue;
+                visited[v] = 1;
+                queue.push_back(v);
+                if (v != nfa.tailNode) numbered.push_back(v);
+            }
+        }
+    } else {
+        for (int u = nfa.orderFirst; u >= 0; u = arena.nextInOrder[u]) {
+            if (u != nfa.headNode && u != nfa.tailNode) numbered.push_back(u);
+        }
+    }
+    for (size_t i = 0; i < numbered.size(); ++i) names[numbered[i]] = std::to_string(i + 1);
+
+    order.clear();
+    order.push_back(nfa.headNode);
+    if (nfa.tailNode != nfa.headNode) order.push_back(nfa.tailNode);
+    order.insert(order.end(), numbered.begin(), numbered.end());
+}
+
+// 位置信息：把正规式中每个字符出现看作一个位置，按后缀表达式自底向上计算每个子表达式的
+// nullable / first / last，并在 '.' 和 '*' 处填充 follow 集合（即龙书中的 firstpos / lastpos / followpos）。
+// Glushkov 构造和直接构造DFA都基于它
+struct PositionInfo {
+    std::vector<char> symbol;             // 各位置上的字符
+    std::vector<std::vector<int>> follow; // follow[p]：可以紧跟在位置 p 之后的位置，升序且不重复
+    std::vector<int> first;               // 整个正规式的 first，升序且不重复
+    std::vector<int> last;
+    bool nullable = false;
+};
+
+struct PositionFragment {
+    bool nullable;
+    std::vector<int> first;
+    std::vector<int> last;
+};
+
+void sortUnique(std::vector<int>& v) {
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+}
+
+bool computePositions(const std::string& postfix, PositionInfo& info) {
+    std::vector<PositionFragment> st;
+    st.reserve(postfix.size());
+
+    for (char c : postfix) {
+        if (c == '~') {
+            // 空串不占位置：可空，first、last 为空
+            st.push_back({true, {}, {}});
+        } else if (!isOperator(c)) {
+            int p = (int)info.symbol.size();
+            info.symbol.push_back(c);
+            info.follow.emplace_back();
+            st.push_back({false, {p}, {p}});
+        } else if (c == '.') {
+            if (st.size() < 2) return false;
+            PositionFragment b = std::move(st.back()); st.pop_back();
+            PositionFragment& a = st.back();
+            for (int p : a.last) info.follow[p].insert(info.follow[p].end(), b.first.begin(), b.first.end());
+            if (a.nullable) a.first.insert(a.first.end(), b.first.begin(), b.first.end());
+            if (b.nullable) b.last.insert(b.last.begin(), a.last.begin(), a.last.end());
+            a.last = std::move(b.last);
+            a.nullable = a.nullable && b.nullable;
+        } else if (c == '|') {
+            if (st.size() < 2) return false;
+            PositionFragment b = std::move(st.back()); st.pop_back();
+            PositionFragment& a = st.back();
+            a.first.insert(a.first.end(), b.first.begin(), b.first.end());
+            a.last.insert(a.last.end(), b.last.begin(), b.last.end());
+            a.nullable = a.nullable || b.nullable;
+        } else if (c == '*') {
+            if (st.empty()) return false;
+            PositionFragment& a = st.back();
+            for (int p : a.last) info.follow[p].insert(info.follow[p].end(), a.first.begin(), a.first.end());
+            a.nullable = true;
+        }
+    }
+    if (st.size() != 1) return false;
+
+    info.first = std::move(st.back().first);
+    info.last = std::move(st.back().last);
+    info.nullable = st.back().nullable;
+    sortUnique(info.first);
+    sortUnique(info.last);
+    for (auto& f : info.follow) sortUnique(f);
+    return true;
+}
+
+// Glushkov（位置自动机）构造：每个位置对应一个状态，没有空边。
+// 状态 0 为初态 X，状态 i + 1 为第 i 个位置；若整个正规式可空，再加一个只由 X 经空边到达的终态，
+// 这是唯一可能出现的空边（文本格式中 X 本身不能是终态）。
+// 终态位置命名为 Y, Y1, Y2 ...，其余位置按出现顺序命名为 1, 2, 3 ...，输出顺序：先 X，再终态，再数字状态
+bool buildGlushkov(const std::string& postfix, NFAArena& arena, std::vector<int>& order,
+                   std::vector<std::string>& names) {
+    PositionInfo info;
+    if (!computePositions(postfix, info)) return false;
+
+    int positions = (int)info.symbol.size();
+    int start = arena.newState();
+    for (int p = 0; p < positions; ++p) arena.newState();
+    int emptyFinal = info.nullable ? arena.newState() : -1;
+
+    // X 的出边：first 集合；位置 p 的出边：follow(p)，都按位置顺序输出
+    for (int q : info.first) arena.addEdge(start, q + 1, info.symbol[q]);
+    if (emptyFinal >= 0) arena.addEdge(start, emptyFinal, '~');
+    for (int p = 0; p < positions; ++p) {
+        for (int q : info.follow[p]) arena.addEdge(p + 1, q + 1, info.symbol[q]);
+    }
+
+    std::vector<char> isFinal(arena.stateCount, 0);
+    for (int p : info.last) isFinal[p + 1] = 1;
+    if (emptyFinal >= 0) isFinal[emptyFinal] = 1;
+
+    names.assign(arena.stateCount, "");
+    names[start] = "X";
+    order.clear();
+    order.push_back(start);
+    int finalCount = 0;
+    if (emptyFinal >= 0) {
+        names[emptyFinal] = "Y";
+        order.push_back(emptyFinal);
+        ++finalCount;
+    }
+    for (int u = 1; u <= positions; ++u) {
+        if (!isFinal[u]) continue;
+        names[u] = finalCount == 0 ? std::string("Y") : "Y" + std::to_string(finalCount);
+        ++finalCount;
+        order.push_back(u);
+    }
+    int numberCount = 0;
+    for (int u = 1; u <= positions; ++u) {
+        if (isFinal[u]) continue;
+        names[u] = std::to_string(++numberCount);
+        order.push_back(u);
+    }
+    return true;
+}
+
+// 位置集合的 hash（集合用升序的 vector<int> 表示）
+struct PositionSetHash {
+    size_t operator()(const std::vector<int>& v) const {
+        size_t h = 1469598103934665603ULL;
+        for (int x : v) {
+            h ^= (size_t)(unsigned)x;
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+};
+
+// 按 order 的顺序把 arena 中的NFA写入 out，名字以 Y 开头的为终态
+void emitNFA(const NFAArena& arena, const std::vector<int>& order, const std::vector<std::string>& names,
+             AutomatonData& out) {
+    std::vector<int> start;
+    std::vector<NFAEdge> adj;
+    arena.toAdjacency(start, adj);
+    std::vector<uint32_t> position(arena.stateCount, 0);
+    for (size_t i = 0; i < order.size(); ++i) position[order[i]] = (uint32_t)i;
+
+    out = AutomatonData();
+    for (int u : order) {
+        out.addState(names[u], names[u][0] == 'Y');
+        for (int i = start[u]; i < start[u + 1]; ++i) out.addEdge(adj[i].pathChar, position[adj[i].to]);
+    }
+    out.startState = 0; // order[0] 总是 X
+}
+
+} // namespace
+
+bool buildNFA(const std::string& regex, NFAConstruction method, AutomatonData& nfa, std::string& error) {
+    std::string postfix;
+    if (!toPostfix(regex, postfix, error)) return false;
+
+    NFAArena arena;
+    arena.reserve(postfix.size());
+    std::vector<int> order;
+    std::vector<std::string> names;
+    if (postfix.empty()) {
+        // 空正规式：只接受空串
+        int x = arena.newState();
+        int y = arena.newState();
+        arena.addEdge(x, y, '~');
+        order = {x, y};
+        names = {"X", "Y"};
+    } else if (method == NFAConstruction::Glushkov) {
+        if (!buildGlushkov(postfix, arena, order, names)) {
+            error = "正规式格式错误";
+            return false;
+        }
+    } else {
+        NFAFragment fragment;
+        if (!buildThompson(postfix, arena, fragment)) {
+            error = "正规式格式错误";
+            return false;
+        }
+        std::vector<int> start;
+        std::vector<NFAEdge> adj;
+        arena.toAdjacency(start, adj);
+        renameStates(arena, fragment, start, adj, method == NFAConstruction::ThompsonBFS, order, names);
+    }
+    emitNFA(arena, order, names, nfa);
+    return true;
+}
+
+// 由 followpos 直接构造DFA（龙书 3.9 节）：在正规式末尾接上结束标记 #，
+// DFA状态是位置集合，初态为 firstpos，经字符 a 转移到 集合中字符为 a 的位置的 followpos 之并，含 # 的状态为终态。
+// 状态按BFS发现顺序、字母表升序展开，命名规则与 determinize 相同：初态 X，终态 Y, Y1, Y2 ...，其余 0, 1, 2 ...
+bool buildDFADirect(const std::string& regex, AutomatonData& dfa, std::string& error) {
+    std::string postfix;
+    if (!toPostfix(regex, postfix, error)) return false;
+
+    dfa = AutomatonData();
+    dfa.flags = FLAG_DETERMINISTIC;
+    if (postfix.empty()) {
+        // 空正规式只接受空串，DFA只有初态 X
+        dfa.addState("X", false);
+        return true;
+    }
+
+    PositionInfo info;
+    if (!computePositions(postfix, info)) {
+        error = "正规式格式错误";
+        return false;
+    }
+
+    // 结束标记 # 记为位置 endMarker：接在 last 集合之后；正规式可空时也在 firstpos 中
+    const int endMarker = (int)info.symbol.size();
+    for (int p : info.last) info.follow[p].push_back(endMarker);
+    std::vector<int> startSet = info.first;
+    if (info.nullable) startSet.push_back(endMarker);
+
+    // 字母表（升序），以及每个位置的字符下标
+    int symbolIndex[256];
+    std::fill(std::begin(symbolIndex), std::end(symbolIndex), -1);
+    for (char c : info.symbol) symbolIndex[(unsigned char)c] = 0;
+    std::vector<char> symbols;
+    for (int c = 0; c < 256; ++c) {
+        if (symbolIndex[c] < 0) continue;
+        symbolIndex[c] = (int)symbols.size();
+        symbols.push_back((char)c);
+    }
+    const size_t k = symbols.size();
+
+    std::unordered_map<std::vector<int>, int, PositionSetHash> setToId;
+    std::vector<const std::vector<int>*> idToSet;
+    auto isFinal = [&](const std::vector<int>& set) { return !set.empty() && set.back() == endMarker; };
+
+    std::vector<std::string> dfaNames(1, "X");
+    std::vector<int> dfaTrans(k, -1);
+    // 初态不放进 setToId，回到同一位置集合时另建状态。determinize 把初态的子集放进子集表，
+    // 但 Thompson NFA 的初态没有入边，其他子集都不含它，所以那里 X 也不会有入边；这里与之输出相同（X 也不能是终态）
+    idToSet.push_back(&startSet);
+    int processIdCnt = 0; // 0, 1, 2...
+    int finalIdCnt = 0;   // Y, Y1, Y2...
+
+    std::vector<std::vector<int>> buckets(k);
+    for (size_t current = 0; current < idToSet.size(); ++current) {
+        // 按字符把 followpos 分桶，一遍扫描得到所有字符的转移
+        for (int p : *idToSet[current]) {
+            if (p == endMarker) continue;
+            int a = symbolIndex[(unsigned char)info.symbol[p]];
+            buckets[a].insert(buckets[a].end(), info.follow[p].begin(), info.follow[p].end());
+        }
+        for (size_t a = 0; a < k; ++a) {
+            if (buckets[a].empty()) continue;
+            sortUnique(buckets[a]);
+            auto it = setToId.find(buckets[a]);
+            int nextId;
+            if (it != setToId.end()) {
+                nextId = it->second;
+            } else {
+                nextId = (int)idToSet.size();
+                if (isFinal(buckets[a])) {
+                    dfaNames.push_back(finalIdCnt == 0 ? std::string("Y") : "Y" + std::to_string(finalIdCnt));
+                    finalIdCnt++;
+                } else {
+                    dfaNames.push_back(std::to_string(processIdCnt++));
+                }
+                idToSet.push_back(&setToId.emplace(buckets[a], nextId).first->first);
+                dfaTrans.resize(dfaTrans.size() + k, -1);
+            }
+            dfaTrans[current * k + a] = nextId;
+            buckets[a].clear();
+        }
+    }
+
+    // 状态按发现顺序编号，终态和数字状态也各自按发现顺序命名，
+    // 所以输出顺序（X，Y...，数字）就是 X、全部终态、全部数字状态各自保持编号顺序
+    std::vector<int> sortedStates(1, 0);
+    for (size_t id = 1; id < dfaNames.size(); ++id) {
+        if (dfaNames[id][0] == 'Y') sortedStates.push_back((int)id);
+    }
+    for (size_t id = 1; id < dfaNames.size(); ++id) {
+        if (dfaNames[id][0] != 'Y') sortedStates.push_back((int)id);
+    }
+    std::vector<uint32_t> position(dfaNames.size());
+    for (size_t i = 0; i < sortedStates.size(); ++i) position[sortedStates[i]] = (uint32_t)i;
+    for (int id : sortedStates) {
+        dfa.addState(dfaNames[id], dfaNames[id][0] == 'Y');
+        for (size_t a = 0; a < k; ++a) {
+            int to = dfaTrans[(size_t)id * k + a];
+            if (to >= 0) dfa.addEdge(symbols[a], position[to]);
+        }
+    }
+    dfa.startState = 0;
+    return true;
+}
+
+} // namespace automata